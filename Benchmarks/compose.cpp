@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+/**
+ * Checks that PPU::ComposeLine() (the vectorized path, if the host has one) produces exactly the same output
+ * as PPU::ComposeLineScalar() for random lines with every EVA, EVB and EVY value, with and without green swap,
+ * and reports the host time spent per line for both. Exits with a non-zero status if any line differs.
+ *
+ * Usage: compose_bench [lines]
+ *
+ * Build together with the core, for example:
+ *   g++ -std=c++20 -O2 -ICore/include -ICore Benchmarks/compose.cpp $(find Core -name '*.cpp') -lfmt -o compose_bench
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <nba/hw/ppu/ppu.hpp>
+#include <random>
+#include <vector>
+
+using namespace nba;
+using nba::core::PPU;
+
+namespace {
+
+struct Line {
+  u16 colors[2][240];
+  u8  effects[240];
+  int eva;
+  int evb;
+  int evy;
+  bool greenswap;
+};
+
+using Compose = void (*)(u16 const*, u16 const*, u8 const*, int, int, int, bool, u32*);
+
+auto Time(Compose compose, std::vector<Line> const& lines, u32* out) -> double {
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for(auto const& line : lines) {
+    compose(line.colors[0], line.colors[1], line.effects, line.eva, line.evb, line.evy, line.greenswap, out);
+  }
+
+  const auto t1 = std::chrono::steady_clock::now();
+
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double)lines.size();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+  std::mt19937 rng{0};
+  std::vector<Line> lines(count);
+
+  for(int i = 0; i < count; i++) {
+    auto& line = lines[i];
+
+    // Bit 15 is set on purpose, PRAM colors may have it set and it must not leak into the output.
+    for(int x = 0; x < 240; x++) {
+      line.colors[0][x] = (u16)rng();
+      line.colors[1][x] = (u16)rng();
+      line.effects[x] = (u8)(rng() % 4);
+    }
+
+    // Cover every value of the (unclamped) 5-bit coefficient fields.
+    line.eva = i % 32;
+    line.evb = (i / 32) % 32;
+    line.evy = (i / 1024) % 32;
+    line.greenswap = (i / 32768) & 1;
+  }
+
+  int mismatches = 0;
+
+  u32 out_vector[240];
+  u32 out_scalar[240];
+
+  for(int i = 0; i < count; i++) {
+    auto const& line = lines[i];
+
+    PPU::ComposeLine(line.colors[0], line.colors[1], line.effects, line.eva, line.evb, line.evy, line.greenswap, out_vector);
+    PPU::ComposeLineScalar(line.colors[0], line.colors[1], line.effects, line.eva, line.evb, line.evy, line.greenswap, out_scalar);
+
+    if(std::memcmp(out_vector, out_scalar, sizeof(out_vector)) != 0) {
+      if(mismatches++ < 10) {
+        for(int x = 0; x < 240; x++) {
+          if(out_vector[x] != out_scalar[x]) {
+            std::printf("line %d (eva=%d evb=%d evy=%d greenswap=%d), pixel %d: 0x%08X != 0x%08X\n",
+              i, line.eva, line.evb, line.evy, line.greenswap, x, out_vector[x], out_scalar[x]);
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  // Alternate between both versions a few times and keep the best run of each.
+  double ns_vector = 1e30;
+  double ns_scalar = 1e30;
+
+  for(int run = 0; run < 5; run++) {
+    ns_vector = std::min(ns_vector, Time(PPU::ComposeLine, lines, out_vector));
+    ns_scalar = std::min(ns_scalar, Time(PPU::ComposeLineScalar, lines, out_scalar));
+  }
+
+  std::printf("%-22s %10.1f ns/line\n", "ComposeLine", ns_vector);
+  std::printf("%-22s %10.1f ns/line\n", "ComposeLineScalar", ns_scalar);
+  std::printf("%d lines, %d mismatches\n", count, mismatches);
+
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+/**
+ * Measures how fast the ARM7TDMI executes a few synthetic instruction loops, in host nanoseconds
+ * (and on x86 also TSC cycles) per guest instruction. The CPU is driven directly, so the
+ * numbers include the bus but none of the PPU, APU or timer work.
+ *
+ * Build together with the core, for example:
+ *   g++ -std=c++20 -O2 -ICore/include -ICore Benchmarks/cpu.cpp $(find Core -name '*.cpp') -lfmt -o cpu_bench
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "system.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #include <x86intrin.h>
+#endif
+
+using namespace nba;
+
+namespace {
+
+struct Workload {
+  char const* name;
+  std::vector<u32> arm;   // ARM code at 0x08000000
+  std::vector<u16> thumb; // Thumb code at 0x08000100 (entered if not empty)
+  int loop_length;        // instructions per iteration of the loop, which increments r0 once
+};
+
+// Sets WAITCNT to 0x4317 (the value most games use: 3/1 ROM wait states with prefetch), r0 to zero and r1 to 0x03000000.
+const std::vector<u32> k_prologue {
+  0xE3A00000, // mov r0, #0
+  0xE3A04301, // mov r4, #0x04000000
+  0xE2844C02, // add r4, r4, #0x200
+  0xE3A05C43, // mov r5, #0x4300
+  0xE3855017, // orr r5, r5, #0x17
+  0xE1C450B4, // strh r5, [r4, #4]
+  0xE3A01403, // mov r1, #0x03000000
+};
+
+auto MakeWorkloads() -> std::vector<Workload> {
+  std::vector<Workload> workloads;
+
+  // ARM ALU and IWRAM load/store loop, running from ROM.
+  {
+    auto code = k_prologue;
+    code.insert(code.end(), {
+      0xE2800001, // loop: add r0, r0, #1
+      0xE5912000, // ldr r2, [r1]
+      0xE5812004, // str r2, [r1, #4]
+      0xE0233002, // eor r3, r3, r2
+      0xEAFFFFFA  // b loop
+    });
+    workloads.push_back({"arm-rom", code, {}, 5});
+  }
+
+  // Thumb ALU and IWRAM load/store loop, running from ROM.
+  {
+    auto code = k_prologue;
+    const u32 thumb_entry = 0x08000100;
+    const u32 pc = 0x08000000 + code.size() * 4 + 8;
+
+    code.insert(code.end(), {
+      0xE28F0000 | (thumb_entry + 1 - pc), // add r0, pc, #offset
+      0xE12FFF10                           // bx r0
+    });
+    workloads.push_back({"thumb-rom", code, {
+      0x2000, // movs r0, #0
+      0x3001, // loop: adds r0, #1
+      0x680A, // ldr r2, [r1, #0]
+      0x604A, // str r2, [r1, #4]
+      0x4053, // eors r3, r2
+      0xE7FA  // b loop
+    }, 5});
+  }
+
+  return workloads;
+}
+
+void Run(Workload const& workload, u32 iterations) {
+  auto system = std::make_unique<bench::System>(std::make_shared<Config>());
+  auto& cpu = system->cpu;
+
+  std::vector<u8> rom(0x200);
+  std::memcpy(rom.data(), workload.arm.data(), workload.arm.size() * sizeof(u32));
+  std::memcpy(rom.data() + 0x100, workload.thumb.data(), workload.thumb.size() * sizeof(u16));
+
+  system->Reset(std::move(rom));
+
+  const auto t0 = std::chrono::steady_clock::now();
+#if defined(__x86_64__) || defined(_M_X64)
+  const u64 tsc0 = __rdtsc();
+#endif
+
+  while(cpu.state.r0 < iterations) {
+    for(int i = 0; i < 1024; i++) {
+      cpu.Run();
+    }
+  }
+
+#if defined(__x86_64__) || defined(_M_X64)
+  const u64 tsc1 = __rdtsc();
+#endif
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const double instructions = (double)cpu.state.r0 * workload.loop_length;
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+
+  std::printf("%-10s %8.2f M instructions, %6.2f ns/instruction", workload.name, instructions / 1e6, ns / instructions);
+#if defined(__x86_64__) || defined(_M_X64)
+  std::printf(", %6.2f TSC cycles/instruction", (double)(tsc1 - tsc0) / instructions);
+#endif
+  std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const u32 iterations = argc > 1 ? std::atoi(argv[1]) : 10000000;
+
+  for(auto const& workload : MakeWorkloads()) {
+    Run(workload, iterations);
+  }
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+/**
+ * Regression check for the CPU fast paths: runs each ROM on a reference core and on a core
+ * with the fast paths enabled in lockstep, and reports the first point at which they diverge.
+ * Exits with a non-zero status if any ROM diverged.
+ *
+ * The subject core fuses copy loops (Config::fuse_copy_loops), which must be cycle-exact.
+ * With -s it also skips idle loops, which is not cycle-accurate and is expected to diverge in timing.
+ * If no BIOS image is given, both cores skip the BIOS and serve its calls through the BIOS HLE.
+ *
+ * Usage: lockstep_check [-f frames] [-i interval] [-m] [-s] [-b bios] <rom>...
+ *   -f  number of frames to run per ROM (default: 3600)
+ *   -i  number of cycles between two comparisons (default: 1232, one scanline)
+ *   -m  also compare EWRAM, IWRAM, PRAM, VRAM and OAM
+ *   -s  also enable idle loop skipping on the subject core
+ *
+ * Build together with the core, for example:
+ *   g++ -std=c++20 -O2 -ICore/include -ICore Benchmarks/lockstep.cpp $(find Core -name '*.cpp') -lfmt -o lockstep_check
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <nba/core.hpp>
+#include <nba/lockstep.hpp>
+#include <optional>
+#include <vector>
+
+using namespace nba;
+
+namespace {
+
+constexpr int k_cycles_per_frame = 280896;
+
+struct Options {
+  int frames = 3600;
+  int interval = 1232;
+  bool compare_memory = false;
+  bool skip_idle_loops = false;
+  std::optional<std::vector<u8>> bios;
+};
+
+auto ReadFile(char const* path) -> std::optional<std::vector<u8>> {
+  std::ifstream file{path, std::ios::binary};
+
+  if(!file.good()) {
+    return std::nullopt;
+  }
+
+  return std::vector<u8>{std::istreambuf_iterator<char>{file}, {}};
+}
+
+auto CreateTestCore(Options const& options, std::vector<u8> rom, bool subject) -> std::unique_ptr<CoreBase> {
+  auto config = std::make_shared<Config>();
+
+  if(subject) {
+    config->fuse_copy_loops = true;
+    config->skip_idle_loops = options.skip_idle_loops;
+  }
+
+  auto core = CreateCore(config);
+
+  if(options.bios.has_value()) {
+    core->Attach(options.bios.value());
+  } else {
+    config->skip_bios = true;
+    config->bios_hle_enable = true;
+  }
+
+  core->Attach(ROM{std::move(rom), nullptr, nullptr});
+  core->Reset();
+  return core;
+}
+
+// Returns true if the ROM ran for the requested number of frames without diverging.
+auto Check(Options const& options, char const* path) -> bool {
+  auto rom = ReadFile(path);
+
+  if(!rom.has_value()) {
+    std::printf("%s: failed to read ROM\n", path);
+    return false;
+  }
+
+  auto reference = CreateTestCore(options, rom.value(), false);
+  auto subject = CreateTestCore(options, std::move(rom.value()), true);
+
+  Lockstep lockstep{*reference, *subject, options.compare_memory};
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for(int frame = 0; frame < options.frames; frame++) {
+    if(auto divergence = lockstep.Run(k_cycles_per_frame, options.interval); divergence.has_value()) {
+      std::printf("%s: diverged in frame %d at timestamp %llu, PC 0x%08X: %s\n",
+        path, frame, (unsigned long long)divergence->timestamp, divergence->pc, divergence->reason.c_str());
+      return false;
+    }
+  }
+
+  const auto t1 = std::chrono::steady_clock::now();
+
+  std::printf("%s: %d frames OK (%.1f s)\n", path, options.frames, std::chrono::duration<double>(t1 - t0).count());
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  int i = 1;
+
+  for(; i < argc && argv[i][0] == '-'; i++) {
+    const char* flag = argv[i];
+
+    if(std::strcmp(flag, "-m") == 0) {
+      options.compare_memory = true;
+    } else if(std::strcmp(flag, "-s") == 0) {
+      options.skip_idle_loops = true;
+    } else if(i + 1 < argc && std::strcmp(flag, "-f") == 0) {
+      options.frames = std::atoi(argv[++i]);
+    } else if(i + 1 < argc && std::strcmp(flag, "-i") == 0) {
+      options.interval = std::max(1, std::atoi(argv[++i]));
+    } else if(i + 1 < argc && std::strcmp(flag, "-b") == 0) {
+      options.bios = ReadFile(argv[++i]);
+
+      if(!options.bios.has_value()) {
+        std::fprintf(stderr, "failed to read BIOS: %s\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    } else {
+      std::fprintf(stderr, "unknown option: %s\n", flag);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if(i == argc) {
+    std::fprintf(stderr, "usage: %s [-f frames] [-i interval] [-m] [-s] [-b bios] <rom>...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  int failures = 0;
+
+  for(; i < argc; i++) {
+    if(!Check(options, argv[i])) {
+      failures++;
+    }
+  }
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
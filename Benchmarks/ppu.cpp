@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+/**
+ * Renders random PPU scenes with the accurate (cycle-by-cycle) renderer and with the scanline renderer
+ * (Config::Video::scanline_renderer), checks that both produce identical frames and reports the host time
+ * spent in the PPU per frame. Half of the scenes also write to PPU registers, PRAM, VRAM and OAM mid-line,
+ * which makes the scanline renderer fall back to the accurate path for the affected lines.
+ * Exits with a non-zero status if any frame differs.
+ *
+ * Usage: ppu_bench [scenes] [frames]
+ *
+ * Build together with the core, for example:
+ *   g++ -std=c++20 -O2 -ICore/include -ICore Benchmarks/ppu.cpp $(find Core -name '*.cpp') -lfmt -o ppu_bench
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "system.hpp"
+
+using namespace nba;
+
+namespace {
+
+constexpr int k_cycles_per_frame = 280896;
+
+struct Capture final : VideoDevice {
+  void Draw(u32* buffer) override {
+    frames.emplace_back(buffer, buffer + 240 * 160);
+  }
+
+  std::vector<std::vector<u32>> frames;
+};
+
+struct Write {
+  u64 timestamp;
+  u32 address;
+  u16 value;
+};
+
+struct Result {
+  std::vector<std::vector<u32>> frames;
+  double seconds;
+};
+
+auto Render(u32 seed, bool scanline_renderer, bool midline_writes, int frames) -> Result {
+  auto config = std::make_shared<Config>();
+  auto capture = std::make_shared<Capture>();
+
+  config->video_dev = capture;
+  config->video.scanline_renderer = scanline_renderer;
+
+  auto system = std::make_unique<bench::System>(config);
+  auto& bus = system->bus;
+  auto& ppu = system->ppu;
+  auto& scheduler = system->scheduler;
+
+  system->Reset(std::vector<u8>(0x400));
+  system->irq.Reset();
+  system->dma.Reset();
+  ppu.Reset();
+
+  std::mt19937 rng{seed};
+
+  const auto Random = [&](u32 range) {
+    return (u32)(rng() % range);
+  };
+
+  u8* vram = ppu.GetVRAM();
+  u8* pram = ppu.GetPRAM();
+  u8* oam = ppu.GetOAM();
+
+  for(int i = 0; i < 0x18000; i++) vram[i] = Random(4) == 0 ? 0 : rng(); // some transparent pixels
+  for(int i = 0; i < 0x400; i++) pram[i] = rng();
+  for(int i = 0; i < 0x400; i++) oam[i] = rng();
+
+  // Keep OBJ tile numbers below 512, so that 8BPP sprites do not read past the end of VRAM.
+  for(int i = 0; i < 128; i++) oam[i * 8 + 5] &= ~2;
+
+  ppu.InvalidateTileCache(0, 0x18000);
+
+  // Random video mode, layers, windows and effects, but no forced blank.
+  static constexpr int k_modes[] { 0, 0, 0, 1, 1, 2, 3, 4, 5 };
+
+  auto& hw = bus.hw;
+
+  hw.WriteHalf(0x04000000, k_modes[Random(std::size(k_modes))] | (rng() & 0xFF70));
+
+  for(u32 address = 0x04000008; address < 0x04000020; address += 2) {
+    hw.WriteHalf(address, rng());
+  }
+
+  for(u32 address = 0x04000020; address < 0x04000040; address += 16) {
+    hw.WriteHalf(address + 0, Random(3) == 0 ? 0x100 : rng());
+    hw.WriteHalf(address + 2, Random(3) == 0 ? 0 : rng());
+    hw.WriteHalf(address + 4, Random(3) == 0 ? 0 : rng());
+    hw.WriteHalf(address + 6, Random(3) == 0 ? 0x100 : rng());
+    hw.WriteWord(address + 8, rng() & 0x0FFF'FFFF);
+    hw.WriteWord(address + 12, rng() & 0x0FFF'FFFF);
+  }
+
+  for(u32 address = 0x04000040; address < 0x0400004C; address += 2) {
+    hw.WriteHalf(address, rng());
+  }
+
+  hw.WriteHalf(0x0400004C, Random(2) == 0 ? 0 : rng());
+  hw.WriteHalf(0x04000050, rng());
+  hw.WriteHalf(0x04000052, rng());
+  hw.WriteHalf(0x04000054, rng());
+
+  std::vector<Write> writes;
+
+  if(midline_writes) {
+    static constexpr u32 k_bases[] { 0x04000000, 0x05000000, 0x06000000, 0x07000000 };
+    static constexpr u32 k_sizes[] { 0x56, 0x400, 0x18000, 0x400 };
+
+    const int count = 1 + Random(40);
+
+    for(int i = 0; i < count; i++) {
+      const int region = Random(4);
+
+      u32 address = k_bases[region] + (Random(k_sizes[region]) & ~1);
+      u16 value = rng();
+
+      // DISPSTAT and VCOUNT would change the timing rather than the picture.
+      if(address == 0x04000004 || address == 0x04000006) {
+        address = 0x04000010;
+      }
+
+      // See above, OBJ tile numbers must stay below 512.
+      if(region == 3 && (address & 7) == 4) {
+        value &= ~0x200;
+      }
+
+      writes.push_back({Random(k_cycles_per_frame * frames), address, value});
+    }
+
+    std::sort(writes.begin(), writes.end(), [](Write const& a, Write const& b) {
+      return a.timestamp < b.timestamp;
+    });
+  }
+
+  const u64 timestamp_start = scheduler.GetTimestampNow();
+  const u64 timestamp_end = timestamp_start + (u64)k_cycles_per_frame * frames;
+
+  // The CPU is not running, so all host time is spent on the PPU (and the scheduler).
+  const auto RunUntil = [&](u64 timestamp) {
+    while(scheduler.GetTimestampNow() < timestamp) {
+      bus.Step((int)std::min<u64>(scheduler.GetRemainingCycleCount(), timestamp - scheduler.GetTimestampNow()));
+    }
+  };
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for(auto const& write : writes) {
+    RunUntil(timestamp_start + write.timestamp);
+    bus.WriteHalf(write.address, write.value, core::Bus::Nonsequential);
+  }
+
+  RunUntil(timestamp_end);
+
+  const auto t1 = std::chrono::steady_clock::now();
+
+  // The first frame is presented right after reset, before the PPU has drawn any line into it.
+  capture->frames.erase(capture->frames.begin());
+
+  return {std::move(capture->frames), std::chrono::duration<double>(t1 - t0).count()};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const int scenes = argc > 1 ? std::atoi(argv[1]) : 100;
+  const int frames = argc > 2 ? std::atoi(argv[2]) : 10;
+
+  int mismatches = 0;
+  double seconds[2][2] {}; // [midline_writes][scanline_renderer]
+
+  for(int seed = 0; seed < scenes; seed++) {
+    for(bool midline_writes : {false, true}) {
+      auto accurate = Render(seed, false, midline_writes, frames);
+      auto scanline = Render(seed, true, midline_writes, frames);
+
+      seconds[midline_writes][0] += accurate.seconds;
+      seconds[midline_writes][1] += scanline.seconds;
+
+      if(accurate.frames != scanline.frames) {
+        std::printf("scene %d%s: frames differ\n", seed, midline_writes ? " (mid-line writes)" : "");
+        mismatches++;
+      }
+    }
+  }
+
+  const double scale = 1000.0 / ((double)scenes * frames);
+
+  std::printf("%-22s %14s %14s\n", "ms per frame", "accurate", "scanline");
+  std::printf("%-22s %14.3f %14.3f\n", "static scenes", seconds[0][0] * scale, seconds[0][1] * scale);
+  std::printf("%-22s %14.3f %14.3f\n", "mid-line writes", seconds[1][0] * scale, seconds[1][1] * scale);
+  std::printf("%d scenes, %d frames each, %d mismatches\n", scenes, frames, mismatches);
+
+  return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
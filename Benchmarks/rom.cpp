@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+/**
+ * Runs a ROM without a frontend for a number of frames and reports the host time per frame.
+ * If no BIOS image is given, the BIOS is skipped and its calls are served by the BIOS HLE.
+ *
+ * When built with NBA_SCHEDULER_STATISTICS defined, it also reports how many
+ * Scheduler::AddCycles() calls took the fast path, without consulting the event heap.
+ *
+ * Usage: rom_bench <rom> [frames] [bios]
+ *
+ * Build together with the core, for example:
+ *   g++ -std=c++20 -O2 -DNBA_SCHEDULER_STATISTICS -ICore/include -ICore Benchmarks/rom.cpp $(find Core -name '*.cpp') -lfmt -o rom_bench
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <nba/core.hpp>
+#include <optional>
+#include <vector>
+
+using namespace nba;
+
+namespace {
+
+auto ReadFile(char const* path) -> std::optional<std::vector<u8>> {
+  std::ifstream file{path, std::ios::binary};
+
+  if(!file.good()) {
+    return std::nullopt;
+  }
+
+  return std::vector<u8>{std::istreambuf_iterator<char>{file}, {}};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if(argc < 2) {
+    std::fprintf(stderr, "usage: %s <rom> [frames] [bios]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const int frames = argc > 2 ? std::atoi(argv[2]) : 3600;
+
+  auto rom = ReadFile(argv[1]);
+
+  if(!rom.has_value()) {
+    std::fprintf(stderr, "failed to read ROM: %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  auto config = std::make_shared<Config>();
+  auto core = CreateCore(config);
+
+  if(argc > 3) {
+    auto bios = ReadFile(argv[3]);
+
+    if(!bios.has_value()) {
+      std::fprintf(stderr, "failed to read BIOS: %s\n", argv[3]);
+      return EXIT_FAILURE;
+    }
+
+    core->Attach(bios.value());
+  } else {
+    config->skip_bios = true;
+    config->bios_hle_enable = true;
+  }
+
+  core->Attach(ROM{std::move(rom.value()), nullptr, nullptr});
+  core->Reset();
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for(int i = 0; i < frames; i++) {
+    core->RunForOneFrame();
+  }
+
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+
+  std::printf("%d frames, %.3f ms/frame, %.1f fps\n", frames, ms / frames, frames * 1000.0 / ms);
+
+#if defined(NBA_SCHEDULER_STATISTICS)
+  auto const& statistics = core->GetScheduler().GetStatistics();
+
+  std::printf("scheduler: %.2f M AddCycles() calls, %.2f%% took the fast path\n",
+    statistics.add_cycles_calls / 1e6,
+    100.0 * (statistics.add_cycles_calls - statistics.heap_steps) / statistics.add_cycles_calls);
+#endif
+}
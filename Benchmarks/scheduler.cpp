@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+/**
+ * Measures the throughput of the scheduler alone: a handful of periodic event sources
+ * (similar to the PPU, APU and timers) re-arm themselves while time advances in small steps,
+ * as the CPU advances it. Reports events per second and host nanoseconds per AddCycles() call.
+ * When built with NBA_SCHEDULER_STATISTICS defined, it also reports the fast path hit rate of AddCycles().
+ *
+ * Build together with the core, for example:
+ *   g++ -std=c++20 -O2 -ICore/include -ICore Benchmarks/scheduler.cpp $(find Core -name '*.cpp') -lfmt -o scheduler_bench
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <nba/scheduler.hpp>
+
+using namespace nba;
+using namespace nba::core;
+
+namespace {
+
+struct Source {
+  Scheduler& scheduler;
+  Scheduler::EventClass event_class;
+  int period;
+  u64 fired = 0;
+
+  void OnEvent() {
+    fired++;
+    scheduler.Add(period, event_class);
+  }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const u64 steps = argc > 1 ? std::atoll(argv[1]) : 200000000;
+
+  Scheduler scheduler;
+
+  Source sources[] {
+    { scheduler, Scheduler::EventClass::PPU_hdraw_vdraw, 1232 },
+    { scheduler, Scheduler::EventClass::APU_mixer,        512 },
+    { scheduler, Scheduler::EventClass::APU_sequencer,   8192 },
+    { scheduler, Scheduler::EventClass::APU_PSG1_generate, 64 },
+    { scheduler, Scheduler::EventClass::APU_PSG2_generate, 96 },
+    { scheduler, Scheduler::EventClass::TM_overflow,       17 }
+  };
+
+  scheduler.Reset();
+
+  for(auto& source : sources) {
+    scheduler.Register<&Source::OnEvent>(source.event_class, &source);
+    scheduler.Add(source.period, source.event_class);
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+
+  for(u64 i = 0; i < steps; i++) {
+    // Mostly single-cycle steps with an occasional longer one, like a stream of bus accesses.
+    scheduler.AddCycles((i & 7) == 0 ? 4 : 1);
+  }
+
+  const auto t1 = std::chrono::steady_clock::now();
+
+  u64 events = 0;
+
+  for(auto const& source : sources) {
+    events += source.fired;
+  }
+
+  const double seconds = std::chrono::duration<double>(t1 - t0).count();
+
+  std::printf("%.2f M events, %.2f M events/s, %.2f ns/AddCycles\n",
+    events / 1e6, events / seconds / 1e6, seconds * 1e9 / steps);
+
+#if defined(NBA_SCHEDULER_STATISTICS)
+  auto const& statistics = scheduler.GetStatistics();
+
+  std::printf("%.2f%% of the AddCycles() calls took the fast path\n",
+    100.0 * (statistics.add_cycles_calls - statistics.heap_steps) / statistics.add_cycles_calls);
+#endif
+}
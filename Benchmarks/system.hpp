@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/arm/arm7tdmi.hpp>
+#include <nba/bus/bus.hpp>
+#include <nba/hw/apu/apu.hpp>
+#include <nba/hw/dma/dma.hpp>
+#include <nba/hw/irq/irq.hpp>
+#include <nba/hw/keypad/keypad.hpp>
+#include <nba/hw/ppu/ppu.hpp>
+#include <nba/hw/timer/timer.hpp>
+#include <nba/scheduler.hpp>
+
+namespace nba::bench {
+
+/**
+ * The components of the core, wired up the same way as in nba::core::Core.
+ * Benchmarks use it to drive the CPU or the bus directly, without the PPU, APU and timer events.
+ */
+struct System {
+  System(std::shared_ptr<Config> config)
+      : cpu(scheduler, bus)
+      , irq(cpu, scheduler)
+      , dma(bus, irq, scheduler)
+      , apu(scheduler, dma, bus, config)
+      , ppu(scheduler, irq, dma, config)
+      , timer(scheduler, irq, apu)
+      , keypad(scheduler, irq)
+      , bus(scheduler, {cpu, irq, dma, apu, ppu, timer, keypad}) {
+  }
+
+  /**
+   * Resets the CPU and the bus, attaches the given ROM and empties the scheduler.
+   * Afterwards the CPU executes from the start of the ROM in System mode.
+   */
+  void Reset(std::vector<u8>&& rom) {
+    bus.Attach(std::vector<u8>(0x4000));
+    bus.Attach(ROM{std::move(rom), nullptr, nullptr});
+    bus.Reset();
+    cpu.Reset();
+    cpu.SwitchMode(core::arm::MODE_SYS);
+    cpu.state.r13 = 0x03007F00;
+    cpu.state.r15 = 0x08000000;
+    scheduler.Reset();
+  }
+
+  core::Scheduler scheduler;
+  core::arm::ARM7TDMI cpu;
+  core::IRQ irq;
+  core::DMA dma;
+  core::APU apu;
+  core::PPU ppu;
+  core::Timer timer;
+  core::KeyPad keypad;
+  core::Bus bus;
+};
+
+} // namespace nba::bench
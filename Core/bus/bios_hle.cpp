@@ -0,0 +1,631 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <cstdlib>
+#include <limits>
+#include <nba/arm/arm7tdmi.hpp>
+#include <nba/bus/bios_hle.hpp>
+#include <nba/bus/bus.hpp>
+#include <nba/bus/io.hpp>
+#include <nba/common/punning.hpp>
+#include <nba/log.hpp>
+
+namespace nba::core {
+
+namespace {
+
+constexpr int kNonseq = Bus::Access::Nonsequential;
+
+// Interrupt flags that the user IRQ handler acknowledges for IntrWait.
+constexpr u32 kIntrCheckFlags = 0x03007FF8;
+
+// sin(2 * pi * i / 256) in 1.14 fixed-point
+constexpr s16 kSineTable[256] {
+      0,    402,    804,   1205,   1606,   2006,   2404,   2801,
+   3196,   3590,   3981,   4370,   4756,   5139,   5520,   5897,
+   6270,   6639,   7005,   7366,   7723,   8076,   8423,   8765,
+   9102,   9434,   9760,  10080,  10394,  10702,  11003,  11297,
+  11585,  11866,  12140,  12406,  12665,  12916,  13160,  13395,
+  13623,  13842,  14053,  14256,  14449,  14635,  14811,  14978,
+  15137,  15286,  15426,  15557,  15679,  15791,  15893,  15986,
+  16069,  16143,  16207,  16261,  16305,  16340,  16364,  16379,
+  16384,  16379,  16364,  16340,  16305,  16261,  16207,  16143,
+  16069,  15986,  15893,  15791,  15679,  15557,  15426,  15286,
+  15137,  14978,  14811,  14635,  14449,  14256,  14053,  13842,
+  13623,  13395,  13160,  12916,  12665,  12406,  12140,  11866,
+  11585,  11297,  11003,  10702,  10394,  10080,   9760,   9434,
+   9102,   8765,   8423,   8076,   7723,   7366,   7005,   6639,
+   6270,   5897,   5520,   5139,   4756,   4370,   3981,   3590,
+   3196,   2801,   2404,   2006,   1606,   1205,    804,    402,
+      0,   -402,   -804,  -1205,  -1606,  -2006,  -2404,  -2801,
+  -3196,  -3590,  -3981,  -4370,  -4756,  -5139,  -5520,  -5897,
+  -6270,  -6639,  -7005,  -7366,  -7723,  -8076,  -8423,  -8765,
+  -9102,  -9434,  -9760, -10080, -10394, -10702, -11003, -11297,
+ -11585, -11866, -12140, -12406, -12665, -12916, -13160, -13395,
+ -13623, -13842, -14053, -14256, -14449, -14635, -14811, -14978,
+ -15137, -15286, -15426, -15557, -15679, -15791, -15893, -15986,
+ -16069, -16143, -16207, -16261, -16305, -16340, -16364, -16379,
+ -16384, -16379, -16364, -16340, -16305, -16261, -16207, -16143,
+ -16069, -15986, -15893, -15791, -15679, -15557, -15426, -15286,
+ -15137, -14978, -14811, -14635, -14449, -14256, -14053, -13842,
+ -13623, -13395, -13160, -12916, -12665, -12406, -12140, -11866,
+ -11585, -11297, -11003, -10702, -10394, -10080,  -9760,  -9434,
+  -9102,  -8765,  -8423,  -8076,  -7723,  -7366,  -7005,  -6639,
+  -6270,  -5897,  -5520,  -5139,  -4756,  -4370,  -3981,  -3590,
+  -3196,  -2801,  -2404,  -2006,  -1606,  -1205,   -804,   -402
+};
+
+auto Sin(u16 angle) -> s32 {
+  return kSineTable[angle >> 8];
+}
+
+auto Cos(u16 angle) -> s32 {
+  return kSineTable[((angle >> 8) + 64) & 255];
+}
+
+// 32-bit multiplication with the wrap-around behaviour of the ARM MUL instruction.
+auto Mul(s32 a, s32 b) -> s32 {
+  return (s32)((u32)a * (u32)b);
+}
+
+/**
+ * The polynomial approximation used by the BIOS ArcTan and ArcTan2 functions.
+ * Also returns the intermediate values that the BIOS leaves in r1 and r3.
+ */
+auto ArcTanPolynomial(s32 tan, s32& r1, s32& r3) -> s32 {
+  s32 a = -(Mul(tan, tan) >> 14);
+  s32 b = ((Mul(0xA9, a) >> 14) + 0x390);
+
+  b = (Mul(b, a) >> 14) + 0x091C;
+  b = (Mul(b, a) >> 14) + 0x0FB6;
+  b = (Mul(b, a) >> 14) + 0x16AA;
+  b = (Mul(b, a) >> 14) + 0x2081;
+  b = (Mul(b, a) >> 14) + 0x3651;
+  b = (Mul(b, a) >> 14) + 0xA2F9;
+
+  r1 = a;
+  r3 = b;
+  return Mul(tan, b) >> 16;
+}
+
+/**
+ * Writes decompressed data byte by byte.
+ * VRAM does not support byte writes, so in that case pairs of bytes are written as halfwords.
+ */
+struct DecompressionOutput {
+  Bus& bus;
+  u32 address;
+  bool vram;
+  u8 pending = 0;
+
+  void Put(u8 value) {
+    if(!vram) {
+      bus.WriteByte(address, value, kNonseq);
+    } else if(address & 1) {
+      bus.WriteHalf(address & ~1, pending | (value << 8), kNonseq);
+    } else {
+      pending = value;
+    }
+    address++;
+  }
+
+  auto Get(u32 distance) -> u8 {
+    if(vram && (address & 1) && distance == 1) {
+      return pending;
+    }
+    return bus.ReadByte(address - distance, kNonseq);
+  }
+};
+
+} // anonymous namespace
+
+void BIOSHLE::Reset() {
+  intr_wait_address = 0xFFFFFFFF;
+}
+
+auto BIOSHLE::HandleSWI(int number) -> Result {
+  auto& state = cpu.state;
+
+  switch(number) {
+    case 0x00: return SoftReset();
+    case 0x01: RegisterRamReset(state.r0); break;
+    case 0x02: {
+      bus.hw.haltcnt = Bus::Hardware::HaltControl::Halt;
+      bus.Step(1);
+      break;
+    }
+    case 0x04: return IntrWait(state.r0 != 0, state.r1);
+    case 0x05: {
+      state.r0 = 1;
+      state.r1 = 1;
+      return IntrWait(true, 1);
+    }
+    case 0x06: Div(state.r0, state.r1); break;
+    case 0x07: Div(state.r1, state.r0); break;
+    case 0x08: Sqrt(state.r0); break;
+    case 0x09: ArcTan(state.r0); break;
+    case 0x0A: ArcTan2(state.r0, state.r1); break;
+    case 0x0B: CpuSet(state.r0, state.r1, state.r2); break;
+    case 0x0C: CpuFastSet(state.r0, state.r1, state.r2); break;
+    case 0x0D: state.r0 = 0xBAAE187F; break; // GetBiosChecksum
+    case 0x0E: BgAffineSet(state.r0, state.r1, state.r2); break;
+    case 0x0F: ObjAffineSet(state.r0, state.r1, state.r2, state.r3); break;
+    case 0x10: BitUnPack(state.r0, state.r1, state.r2); break;
+    case 0x11: LZ77UnComp(state.r0, state.r1, false); break;
+    case 0x12: LZ77UnComp(state.r0, state.r1, true); break;
+    case 0x13: HuffUnComp(state.r0, state.r1); break;
+    case 0x14: RLUnComp(state.r0, state.r1, false); break;
+    case 0x15: RLUnComp(state.r0, state.r1, true); break;
+    default: {
+      if(stub_bios) {
+        Log<Warn>("BIOSHLE: SWI 0x{:02X} is not supported without a BIOS image, ignoring it.", number);
+      }
+      return Result::Unhandled;
+    }
+  }
+
+  return Result::Return;
+}
+
+auto BIOSHLE::SoftReset() -> Result {
+  auto& state = cpu.state;
+
+  // The flag selecting the entry point lives in the area that is cleared below.
+  const bool ram_entry = bus.ReadByte(0x03007FFA, kNonseq) != 0;
+
+  for(u32 address = 0x03007E00; address < 0x03008000; address += sizeof(u32)) {
+    bus.WriteWord(address, 0, kNonseq);
+  }
+
+  cpu.SwitchMode(arm::MODE_SYS);
+  state.cpsr.v = arm::MODE_SYS;
+
+  for(int bank : {arm::BANK_SVC, arm::BANK_IRQ}) {
+    state.bank[bank][arm::BANK_R14] = 0;
+    state.spsr[bank].v = 0;
+  }
+  state.bank[arm::BANK_SVC][arm::BANK_R13] = 0x03007FE0;
+  state.bank[arm::BANK_IRQ][arm::BANK_R13] = 0x03007FA0;
+
+  for(int i = 0; i <= 12; i++) {
+    state.reg[i] = 0;
+  }
+  state.r13 = 0x03007F00;
+  state.r14 = 0;
+  state.r15 = ram_entry ? 0x02000000 : 0x08000000;
+  return Result::Jump;
+}
+
+auto BIOSHLE::IntrWait(bool discard_old_flags, u16 wait_flags) -> Result {
+  auto& state = cpu.state;
+
+  // The SWI is executed again after each IRQ until one of the flags is set.
+  const u32 address = state.r15 - (state.cpsr.f.thumb ? 4 : 8);
+  const bool first_call = address != intr_wait_address;
+
+  bus.WriteHalf(IME, 1, kNonseq);
+
+  u16 flags = bus.ReadHalf(kIntrCheckFlags, kNonseq);
+
+  if(first_call && discard_old_flags) {
+    bus.WriteHalf(kIntrCheckFlags, flags & ~wait_flags, kNonseq);
+  } else if(flags & wait_flags) {
+    bus.WriteHalf(kIntrCheckFlags, flags & ~wait_flags, kNonseq);
+    intr_wait_address = 0xFFFFFFFF;
+    return Result::Return;
+  }
+
+  intr_wait_address = address;
+
+  /* The BIOS waits in SVC mode and briefly enables IRQs after each halt, regardless of
+   * the caller's CPSR.I. Halting alone would never get the IRQ serviced in that case.
+   */
+  if(state.cpsr.f.mask_irq && cpu.IRQLine()) {
+    return Result::Interrupt;
+  }
+
+  bus.hw.haltcnt = Bus::Hardware::HaltControl::Halt;
+  bus.Step(1);
+  return Result::Repeat;
+}
+
+void BIOSHLE::RegisterRamReset(u32 flags) {
+  const auto Clear = [&](u32 address, u32 size) {
+    for(u32 offset = 0; offset < size; offset += sizeof(u32)) {
+      bus.WriteWord(address + offset, 0, kNonseq);
+    }
+  };
+
+  const auto ClearIO = [&](u32 address_lo, u32 address_hi) {
+    for(u32 address = address_lo; address <= address_hi; address += sizeof(u16)) {
+      bus.WriteHalf(address, 0, kNonseq);
+    }
+  };
+
+  bus.WriteHalf(DISPCNT, 0x0080, kNonseq);
+
+  if(flags & 0x01) Clear(0x02000000, 0x40000);
+  if(flags & 0x02) Clear(0x03000000, 0x7E00); // the top 512 bytes hold the BIOS stack and IRQ vector
+  if(flags & 0x04) Clear(0x05000000, 0x400);
+  if(flags & 0x08) Clear(0x06000000, 0x18000);
+  if(flags & 0x10) Clear(0x07000000, 0x400);
+
+  if(flags & 0x20) {
+    ClearIO(SIODATA32_L, SIOCNT + 2);
+    bus.WriteHalf(RCNT, 0x8000, kNonseq);
+  }
+
+  if(flags & 0x40) {
+    ClearIO(0x04000060, 0x04000086);
+    ClearIO(0x04000090, 0x0400009E);
+  }
+
+  if(flags & 0x80) {
+    ClearIO(0x04000004, 0x04000054);
+    ClearIO(0x040000B0, 0x040000DE);
+    ClearIO(0x04000100, 0x0400010E);
+    ClearIO(IE, IE);
+    bus.WriteHalf(IF, 0xFFFF, kNonseq);
+    ClearIO(WAITCNT, IME);
+  }
+}
+
+void BIOSHLE::Div(s32 numerator, s32 denominator) {
+  auto& state = cpu.state;
+
+  if(denominator == 0) {
+    // Division by zero does not produce a meaningful result on hardware.
+    state.r0 = numerator < 0 ? -1 : 1;
+    state.r1 = numerator;
+    state.r3 = 1;
+  } else if(numerator == std::numeric_limits<s32>::min() && denominator == -1) {
+    state.r0 = numerator;
+    state.r1 = 0;
+    state.r3 = numerator;
+  } else {
+    s32 quotient = numerator / denominator;
+
+    state.r0 = quotient;
+    state.r1 = numerator % denominator;
+    state.r3 = std::abs(quotient);
+  }
+
+  // Roughly what the shift-and-subtract loop of the BIOS takes.
+  bus.Step(80);
+}
+
+void BIOSHLE::Sqrt(u32 value) {
+  u32 result = 0;
+  u32 bit = 1U << 30;
+
+  while(bit > value) bit >>= 2;
+
+  while(bit != 0) {
+    if(value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  cpu.state.r0 = result;
+  bus.Step(150);
+}
+
+void BIOSHLE::ArcTan(s32 tan) {
+  s32 r1;
+  s32 r3;
+
+  cpu.state.r0 = ArcTanPolynomial(tan, r1, r3);
+  cpu.state.r1 = r1;
+  cpu.state.r3 = r3;
+  bus.Step(40);
+}
+
+void BIOSHLE::ArcTan2(s32 x, s32 y) {
+  s32 r1 = cpu.state.r1;
+  s32 r3 = cpu.state.r3;
+  s32 angle;
+
+  x = (s16)x;
+  y = (s16)y;
+
+  if(y == 0) {
+    angle = x >= 0 ? 0x0000 : 0x8000;
+  } else if(x == 0) {
+    angle = y >= 0 ? 0x4000 : 0xC000;
+  } else if(y >= 0) {
+    if(x >= 0 && x >= y) {
+      angle = ArcTanPolynomial((y << 14) / x, r1, r3);
+    } else if(x < 0 && -x >= y) {
+      angle = ArcTanPolynomial((y << 14) / x, r1, r3) + 0x8000;
+    } else {
+      angle = 0x4000 - ArcTanPolynomial((x << 14) / y, r1, r3);
+    }
+  } else {
+    if(x <= 0 && -x > -y) {
+      angle = ArcTanPolynomial((y << 14) / x, r1, r3) + 0x8000;
+    } else if(x > 0 && x >= -y) {
+      angle = ArcTanPolynomial((y << 14) / x, r1, r3) + 0x10000;
+    } else {
+      angle = 0xC000 - ArcTanPolynomial((x << 14) / y, r1, r3);
+    }
+  }
+
+  cpu.state.r0 = (u16)angle;
+  cpu.state.r1 = r1;
+  cpu.state.r3 = r3;
+  bus.Step(80);
+}
+
+void BIOSHLE::CpuSet(u32 src, u32 dst, u32 control) {
+  const bool fill = control & (1 << 24);
+  const u32 count = control & 0x1FFFFF;
+
+  // The BIOS refuses to copy from its own memory region.
+  if((src & 0x0E000000) == 0) {
+    return;
+  }
+
+  if(control & (1 << 26)) {
+    src &= ~3;
+    dst &= ~3;
+
+    u32 value = bus.ReadWord(src, kNonseq);
+
+    for(u32 i = 0; i < count; i++) {
+      if(!fill && i != 0) value = bus.ReadWord(src + i * 4, kNonseq);
+      bus.WriteWord(dst + i * 4, value, kNonseq);
+    }
+  } else {
+    src &= ~1;
+    dst &= ~1;
+
+    u16 value = bus.ReadHalf(src, kNonseq);
+
+    for(u32 i = 0; i < count; i++) {
+      if(!fill && i != 0) value = bus.ReadHalf(src + i * 2, kNonseq);
+      bus.WriteHalf(dst + i * 2, value, kNonseq);
+    }
+  }
+}
+
+void BIOSHLE::CpuFastSet(u32 src, u32 dst, u32 control) {
+  // CpuFastSet always transfers words in blocks of eight.
+  const u32 count = ((control & 0x1FFFFF) + 7) & ~7;
+
+  CpuSet(src, dst, (control & (1 << 24)) | (1 << 26) | count);
+}
+
+void BIOSHLE::BgAffineSet(u32 src, u32 dst, int count) {
+  for(int i = 0; i < count; i++) {
+    const s32 origin_x = (s32)bus.ReadWord(src +  0, kNonseq);
+    const s32 origin_y = (s32)bus.ReadWord(src +  4, kNonseq);
+    const s32 center_x = (s16)bus.ReadHalf(src +  8, kNonseq);
+    const s32 center_y = (s16)bus.ReadHalf(src + 10, kNonseq);
+    const s32 scale_x  = (s16)bus.ReadHalf(src + 12, kNonseq);
+    const s32 scale_y  = (s16)bus.ReadHalf(src + 14, kNonseq);
+    const u16 angle = bus.ReadHalf(src + 16, kNonseq);
+
+    const s32 pa = ( scale_x * Cos(angle)) >> 14;
+    const s32 pb = (-scale_x * Sin(angle)) >> 14;
+    const s32 pc = ( scale_y * Sin(angle)) >> 14;
+    const s32 pd = ( scale_y * Cos(angle)) >> 14;
+
+    bus.WriteHalf(dst + 0, (u16)pa, kNonseq);
+    bus.WriteHalf(dst + 2, (u16)pb, kNonseq);
+    bus.WriteHalf(dst + 4, (u16)pc, kNonseq);
+    bus.WriteHalf(dst + 6, (u16)pd, kNonseq);
+    bus.WriteWord(dst + 8, (u32)(origin_x - (pa * center_x + pb * center_y)), kNonseq);
+    bus.WriteWord(dst + 12, (u32)(origin_y - (pc * center_x + pd * center_y)), kNonseq);
+
+    src += 20;
+    dst += 16;
+  }
+}
+
+void BIOSHLE::ObjAffineSet(u32 src, u32 dst, int count, int stride) {
+  for(int i = 0; i < count; i++) {
+    const s32 scale_x = (s16)bus.ReadHalf(src + 0, kNonseq);
+    const s32 scale_y = (s16)bus.ReadHalf(src + 2, kNonseq);
+    const u16 angle = bus.ReadHalf(src + 4, kNonseq);
+
+    bus.WriteHalf(dst + stride * 0, (u16)(( scale_x * Cos(angle)) >> 14), kNonseq);
+    bus.WriteHalf(dst + stride * 1, (u16)((-scale_x * Sin(angle)) >> 14), kNonseq);
+    bus.WriteHalf(dst + stride * 2, (u16)(( scale_y * Sin(angle)) >> 14), kNonseq);
+    bus.WriteHalf(dst + stride * 3, (u16)(( scale_y * Cos(angle)) >> 14), kNonseq);
+
+    src += 8;
+    dst += stride * 4;
+  }
+}
+
+void BIOSHLE::BitUnPack(u32 src, u32 dst, u32 info) {
+  const u16 length = bus.ReadHalf(info + 0, kNonseq);
+  const int src_width = bus.ReadByte(info + 2, kNonseq);
+  const int dst_width = bus.ReadByte(info + 3, kNonseq);
+  const u32 offset = bus.ReadWord(info + 4, kNonseq);
+
+  // Only widths that evenly divide a byte (source) or a word (destination) are valid.
+  if(src_width == 0 || src_width > 8 || (src_width & (src_width - 1)) != 0 ||
+     dst_width == 0 || dst_width > 32 || (dst_width & (dst_width - 1)) != 0) {
+    return;
+  }
+
+  const bool offset_zero_data = offset & 0x80000000;
+  const u32 data_offset = offset & 0x7FFFFFFF;
+  const u32 src_mask = (1 << src_width) - 1;
+
+  u32 buffer = 0;
+  int buffer_bits = 0;
+
+  // The output is assembled and written in words, which means it also works with VRAM.
+  for(u32 i = 0; i < length; i++) {
+    const u8 byte = bus.ReadByte(src + i, kNonseq);
+
+    for(int bit = 0; bit < 8; bit += src_width) {
+      u32 value = (byte >> bit) & src_mask;
+
+      if(value != 0 || offset_zero_data) {
+        value += data_offset;
+      }
+
+      buffer |= value << buffer_bits;
+      buffer_bits += dst_width;
+
+      if(buffer_bits == 32) {
+        bus.WriteWord(dst, buffer, kNonseq);
+        dst += sizeof(u32);
+        buffer = 0;
+        buffer_bits = 0;
+      }
+    }
+  }
+}
+
+void BIOSHLE::LZ77UnComp(u32 src, u32 dst, bool vram) {
+  const u32 size = bus.ReadWord(src, kNonseq) >> 8;
+
+  DecompressionOutput output{bus, dst, vram};
+
+  src += sizeof(u32);
+
+  for(u32 written = 0; written < size;) {
+    u8 flags = bus.ReadByte(src++, kNonseq);
+
+    for(int i = 0; i < 8 && written < size; i++) {
+      if(flags & 0x80) {
+        const u8 byte0 = bus.ReadByte(src++, kNonseq);
+        const u8 byte1 = bus.ReadByte(src++, kNonseq);
+        const u32 distance = (((byte0 & 15) << 8) | byte1) + 1;
+        const u32 length = (byte0 >> 4) + 3;
+
+        for(u32 j = 0; j < length && written < size; j++) {
+          output.Put(output.Get(distance));
+          written++;
+        }
+      } else {
+        output.Put(bus.ReadByte(src++, kNonseq));
+        written++;
+      }
+
+      flags <<= 1;
+    }
+  }
+}
+
+void BIOSHLE::HuffUnComp(u32 src, u32 dst) {
+  const u32 header = bus.ReadWord(src, kNonseq);
+  const int data_bits = header & 15;
+  const u32 size = header >> 8;
+
+  if(data_bits != 4 && data_bits != 8) {
+    return;
+  }
+
+  // The tree follows the header, prefixed by its size in halfwords minus one.
+  const u32 tree = src + 4;
+  const u32 root = tree + 1;
+
+  u32 stream = tree + (bus.ReadByte(tree, kNonseq) + 1) * 2;
+  u32 node_address = root;
+  u8  node = bus.ReadByte(root, kNonseq);
+
+  u32 buffer = 0;
+  int buffer_bits = 0;
+
+  // The output is assembled and written in words, like BitUnPack.
+  for(u32 written = 0; written < size;) {
+    u32 bits = bus.ReadWord(stream, kNonseq);
+
+    stream += sizeof(u32);
+
+    for(int i = 0; i < 32 && written < size; i++) {
+      const int direction = bits >> 31;
+      const bool is_data = node & (direction ? 0x40 : 0x80);
+
+      bits <<= 1;
+      node_address = (node_address & ~1) + (node & 0x3F) * 2 + 2 + direction;
+      node = bus.ReadByte(node_address, kNonseq);
+
+      if(is_data) {
+        buffer |= node << buffer_bits;
+        buffer_bits += data_bits;
+
+        if(buffer_bits == 32) {
+          bus.WriteWord(dst, buffer, kNonseq);
+          dst += sizeof(u32);
+          written += sizeof(u32);
+          buffer = 0;
+          buffer_bits = 0;
+        }
+
+        node_address = root;
+        node = bus.ReadByte(root, kNonseq);
+      }
+    }
+  }
+}
+
+void BIOSHLE::RLUnComp(u32 src, u32 dst, bool vram) {
+  const u32 size = bus.ReadWord(src, kNonseq) >> 8;
+
+  DecompressionOutput output{bus, dst, vram};
+
+  src += sizeof(u32);
+
+  for(u32 written = 0; written < size;) {
+    const u8 flag = bus.ReadByte(src++, kNonseq);
+
+    if(flag & 0x80) {
+      const u32 length = (flag & 0x7F) + 3;
+      const u8 value = bus.ReadByte(src++, kNonseq);
+
+      for(u32 j = 0; j < length && written < size; j++) {
+        output.Put(value);
+        written++;
+      }
+    } else {
+      const u32 length = (flag & 0x7F) + 1;
+
+      for(u32 j = 0; j < length && written < size; j++) {
+        output.Put(bus.ReadByte(src++, kNonseq));
+        written++;
+      }
+    }
+  }
+}
+
+auto BIOSHLE::GetStubImage() -> std::vector<u8> {
+  static constexpr u32 kStub[] {
+    0xE3A0F302, // 0x00: mov pc, #0x08000000  (reset)
+    0xE1B0F00E, // 0x04: movs pc, lr          (undefined instruction)
+    0xE1B0F00E, // 0x08: movs pc, lr          (SWI not handled by the HLE)
+    0xE25EF004, // 0x0C: subs pc, lr, #4      (prefetch abort)
+    0xE25EF008, // 0x10: subs pc, lr, #8      (data abort)
+    0xE1B0F00E, // 0x14: movs pc, lr          (reserved)
+    0xEA000000, // 0x18: b 0x20               (IRQ)
+    0xE25EF004, // 0x1C: subs pc, lr, #4      (FIQ)
+    0xE92D500F, // 0x20: stmfd sp!, {r0-r3, r12, lr}
+    0xE3A00301, // 0x24: mov r0, #0x04000000
+    0xE28FE000, // 0x28: add lr, pc, #0
+    0xE510F004, // 0x2C: ldr pc, [r0, #-4]    (user IRQ handler at 0x03FFFFFC)
+    0xE8BD500F, // 0x30: ldmfd sp!, {r0-r3, r12, lr}
+    0xE25EF004  // 0x34: subs pc, lr, #4
+  };
+
+  std::vector<u8> image(sizeof(kStub));
+
+  for(size_t i = 0; i < std::size(kStub); i++) {
+    write<u32>(image.data(), i * sizeof(u32), kStub[i]);
+  }
+  return image;
+}
+
+} // namespace nba::core
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <nba/common/punning.hpp>
 #include <nba/common/scope_exit.hpp>
+#include <span>
 #include <stdexcept>
 
 #include <nba/arm/arm7tdmi.hpp>
@@ -20,7 +21,7 @@ namespace nba::core {
 Bus::Bus(Scheduler& scheduler, Hardware&& hw)
     : scheduler(scheduler)
     , hw(hw) {
-  scheduler.Register(Scheduler::EventClass::SIO_transfer_done, this, &Bus::SIOTransferDone);
+  scheduler.Register<&Bus::SIOTransferDone>(Scheduler::EventClass::SIO_transfer_done, this);
 
   this->hw.bus = this;
   memory.bios.fill(0);
@@ -56,6 +57,8 @@ void Bus::Attach(std::vector<u8> const& bios) {
 
 void Bus::Attach(ROM&& rom) {
   memory.rom = std::move(rom);
+  host_generation++;
+  UpdatePageTable();
 }
 
 auto Bus::ReadByte(u32 address, int access) ->  u8 {
@@ -84,6 +87,21 @@ void Bus::WriteWord(u32 address, u32 value, int access) {
 
 template<typename T>
 auto Bus::Read(u32 address, int access) -> T {
+  if(!(access & Code) && unlikely(page_table[address >> 24].watched)) {
+    // Let a pending DMA finish first, so that the record carries the time the CPU access really happens.
+    if(!(access & (Dma | Lock)) && hw.dma.IsRunning()) hw.dma.Run();
+
+    const u64 timestamp = scheduler.GetTimestampNow();
+    const T value = ReadMemory<T>(address, access);
+    OnWatchedAccess(address, timestamp, sizeof(T), value, MemoryAccess::Read, access);
+    return value;
+  }
+
+  return ReadMemory<T>(address, access);
+}
+
+template<typename T>
+auto Bus::ReadMemory(u32 address, int access) -> T {
   auto page = address >> 24;
   auto is_u32 = std::is_same_v<T, u32>;
 
@@ -186,6 +204,17 @@ auto Bus::Read(u32 address, int access) -> T {
 
 template<typename T>
 void Bus::Write(u32 address, int access, T value) {
+  if(unlikely(page_table[address >> 24].watched)) {
+    if(!(access & (Dma | Lock)) && hw.dma.IsRunning()) hw.dma.Run();
+
+    OnWatchedAccess(address, scheduler.GetTimestampNow(), sizeof(T), value, MemoryAccess::Write, access);
+  }
+
+  WriteMemory<T>(address, access, value);
+}
+
+template<typename T>
+void Bus::WriteMemory(u32 address, int access, T value) {
   auto page = address >> 24;
   auto is_u32 = std::is_same_v<T, u32>;
 
@@ -355,50 +384,103 @@ auto Bus::ReadOpenBus(u32 address) -> u32 {
   return word >> shift;
 }
 
-auto Bus::GetHostAddress(u32 address, size_t size) -> u8* {
-  auto& bios = memory.bios;
-  auto& wram = memory.wram;
-  auto& iram = memory.iram;
-  auto& rom = memory.rom.GetRawROM();
+void Bus::UpdatePageTable() {
+  using Type = Page::Type;
 
-  auto page = address >> 24;
+  page_table.fill({});
 
-  switch(page) {
+  // BIOS (reads are only allowed while the CPU executes from the BIOS)
+  page_table[0x00] = {Type::BIOS, memory.bios.data(), nullptr, 0x00FF'FFFF, 0, (u32)memory.bios.size(), 1, 1};
+
+  // EWRAM (external work RAM)
+  page_table[0x02] = {Type::RAM, memory.wram.data(), memory.wram.data(), 0x3FFFF, 0, (u32)memory.wram.size(), 3, 6};
+
+  // IWRAM (internal work RAM)
+  page_table[0x03] = {Type::RAM, memory.iram.data(), memory.iram.data(), 0x7FFF, 0, (u32)memory.iram.size(), 1, 1};
+
+  /* ROM (WS0, WS1, WS2). Mirrored ROMs are left to the slow path, since
+   * GPIO and EEPROM decode the address before the mirror mask is applied.
+   */
+  auto& rom = memory.rom;
+
+  if(rom.GetAddressMask() == 0x01FF'FFFF) {
+    const auto [begin, end] = rom.GetPlainDataRange();
+
+    const u8* data = rom.GetRawROM().data();
+
+    for(int page = 0x08; page <= 0x0D; page++) {
+      page_table[page] = {Type::ROM, data, nullptr, 0x01FF'FFFF, begin, end, wait16[0][page], wait32[0][page]};
+    }
+  }
+
+  const auto Watch = [&](int page) {
+    page_table[page].type = Type::Slow;
+    page_table[page].watched = true;
+  };
+
+  if(access_tracing) {
+    for(int page = 0; page < 256; page++) Watch(page);
+  } else {
+    for(auto const& watchpoint : watchpoints) {
+      const u64 last_address = std::min<u64>((u64)watchpoint.address + std::max(watchpoint.size, 1u) - 1, 0xFFFF'FFFF);
+
+      for(u32 page = watchpoint.address >> 24; page <= last_address >> 24; page++) Watch(page);
+    }
+  }
+}
+
+template<typename T>
+static auto ResolveHostSpan(T* data, u32 offset, size_t capacity, size_t size) -> std::span<T> {
+  if(offset + size <= capacity) {
+    return {data + offset, size};
+  }
+  return {};
+}
+
+auto Bus::GetHostSpan(u32 address, size_t size) -> std::span<u8 const> {
+  switch(address >> 24) {
     // BIOS
     case 0x00: {
-      auto offset = address & 0x00FF'FFFF;
-      if(offset + size <= bios.size()) {
-        return bios.data() + offset;
-      }
-      break;
+      return ResolveHostSpan(memory.bios.data(), address & 0x00FF'FFFF, memory.bios.size(), size);
+    }
+    // ROM (WS0, WS1, WS2)
+    case 0x08 ... 0x0D: {
+      auto rom = memory.rom.GetRawROM();
+
+      return ResolveHostSpan(rom.data(), address & memory.rom.GetAddressMask(), rom.size(), size);
+    }
+    // VRAM (video RAM), resolved here so that reading it leaves the tile cache alone
+    case 0x06: {
+      return ResolveHostSpan(hw.ppu.GetVRAM(), address & 0x1FFFF, 0x18000, size);
     }
+  }
+
+  return GetWritableHostSpan(address, size);
+}
+
+auto Bus::GetWritableHostSpan(u32 address, size_t size) -> std::span<u8> {
+  switch(address >> 24) {
     // EWRAM (external work RAM)
     case 0x02: {
-      auto offset = address & 0x00FF'FFFF;
-      if(offset + size <= wram.size()) {
-        return wram.data() + offset;
-      }
-      break;
+      return ResolveHostSpan(memory.wram.data(), address & 0x3FFFF, memory.wram.size(), size);
     }
     // IWRAM (internal work RAM)
     case 0x03: {
-      auto offset = address & 0x00FF'FFFF;
-      if(offset + size <= iram.size()) {
-        return iram.data() + offset;
-      }
-      break;
+      return ResolveHostSpan(memory.iram.data(), address & 0x7FFF, memory.iram.size(), size);
     }
-    // ROM (WS0, WS1, WS2)
-    case 0x08 ... 0x0D: {
-      auto offset = address & 0x01FF'FFFF;
-      if(offset + size <= rom.size()) {
-        return rom.data() + offset;
+    // VRAM (video RAM), except for the mirrored OBJ area
+    case 0x06: {
+      auto span = ResolveHostSpan(hw.ppu.GetVRAM(), address & 0x1FFFF, 0x18000, size);
+
+      // The caller is going to write to the range, which the PPU would not notice otherwise.
+      if(!span.empty()) {
+        hw.ppu.InvalidateTileCache(address & 0x1FFFF, size);
       }
-      break;
+      return span;
     }
   }
 
-  return nullptr;
+  return {};
 }
 
 } // namespace nba::core
@@ -537,6 +537,10 @@ void Bus::Hardware::WriteByte(u32 address,  u8 value) {
     }
     case WAITCNT+1: {
       const bool prefetch_old = waitcnt.prefetch;
+      if(bus->prefetch.active) {
+        // Catch up with the prefetch unit before it observes the new setting.
+        bus->SyncPrefetch();
+      }
       waitcnt.ws2[0] = (value >> 0) & 3;
       waitcnt.ws2[1] = (value >> 2) & 1;
       waitcnt.phi = (value >> 3) & 3;
@@ -36,6 +36,7 @@ void Bus::LoadState(SaveState const& state) {
   prefetch.count = state.bus.prefetch.count;
   prefetch.countdown = state.bus.prefetch.countdown;
   prefetch.thumb = state.bus.prefetch.thumb;
+  prefetch.timestamp = scheduler.GetTimestampNow();
   if(prefetch.thumb) {
     prefetch.opcode_width = sizeof(u16);
     prefetch.capacity = 8;
@@ -72,6 +73,9 @@ void Bus::CopyState(SaveState& state) {
   state.bus.io.postflg = hw.postflg;
   state.bus.prefetch_buffer_was_disabled = hw.prefetch_buffer_was_disabled;
 
+  if(prefetch.active) {
+    SyncPrefetch();
+  }
   state.bus.prefetch.active = prefetch.active;
   state.bus.prefetch.head_address = prefetch.head_address;
   state.bus.prefetch.count = prefetch.count;
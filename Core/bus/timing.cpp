@@ -5,6 +5,8 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+#include <limits>
 #include <nba/arm/arm7tdmi.hpp>
 #include <nba/bus/bus.hpp>
 
@@ -42,6 +44,8 @@ void Bus::Prefetch(u32 address, bool code, int cycles) {
   }
 
   if(prefetch.active) {
+    SyncPrefetch();
+
     // Case #1: requested address is the first entry in the prefetch buffer.
     if(prefetch.count != 0 && address == prefetch.head_address) {
       prefetch.count--;
@@ -53,6 +57,7 @@ void Bus::Prefetch(u32 address, bool code, int cycles) {
     // Case #2: requested address is currently being prefetched.
     if(prefetch.countdown > 0 && address == prefetch.last_address) {
       Step(prefetch.countdown);
+      SyncPrefetch();
       prefetch.head_address = prefetch.last_address;
       prefetch.count = 0;
       return;
@@ -92,11 +97,14 @@ void Bus::Prefetch(u32 address, bool code, int cycles) {
     prefetch.countdown = prefetch.duty;
     prefetch.last_address = address + prefetch.opcode_width;
     prefetch.head_address = prefetch.last_address;
+    prefetch.timestamp = scheduler.GetTimestampNow();
   }
 }
 
 void Bus::StopPrefetch() {
   if(prefetch.active) {
+    SyncPrefetch();
+
     u32 r15 = hw.cpu.state.r15;
 
     /* If ROM data/SRAM/FLASH is accessed in a cycle, where the prefetch unit
@@ -116,21 +124,35 @@ void Bus::StopPrefetch() {
   }
 }
 
-void Bus::Step(int cycles) {
-  scheduler.AddCycles(cycles);
+void Bus::SyncPrefetch() {
+  /**
+   * The prefetch unit is not stepped on every bus access. Instead we catch up
+   * with the cycles elapsed since the last sync, whenever its state is queried.
+   * Its state only depends on the elapsed time, so this gives the same result.
+   */
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+  const u64 elapsed = timestamp_now - prefetch.timestamp;
 
-  if(prefetch.active) {
-    prefetch.countdown -= cycles;
+  StepPrefetch((int)std::min<u64>(elapsed, std::numeric_limits<int>::max()));
+  prefetch.timestamp = timestamp_now;
+}
 
-    while(prefetch.countdown <= 0) {
-      prefetch.count++;
+void Bus::StepPrefetch(int cycles) {
+  prefetch.countdown -= cycles;
 
-      if(hw.waitcnt.prefetch && prefetch.count < prefetch.capacity) {
-        prefetch.last_address += prefetch.opcode_width;
-        prefetch.countdown += prefetch.duty;
-      } else {
-        break;
-      }
+  while(prefetch.countdown <= 0) {
+    prefetch.count++;
+
+    if(hw.waitcnt.prefetch && prefetch.count < prefetch.capacity) {
+      prefetch.last_address += prefetch.opcode_width;
+      prefetch.countdown += prefetch.duty;
+    } else {
+      /* The buffer is full or prefetching was disabled: the unit stalls.
+       * Each further sync still counts one more entry, so a full buffer does
+       * not drain while code keeps executing sequentially from it.
+       */
+      prefetch.countdown = 0;
+      break;
     }
   }
 }
@@ -173,6 +195,8 @@ void Bus::UpdateWaitStateTable() {
     wait16[s][0xE + i] = sram;
     wait32[s][0xE + i] = sram;
   }
+
+  UpdatePageTable();
 }
 
 } // namespace nba::core
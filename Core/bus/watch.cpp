@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <nba/arm/arm7tdmi.hpp>
+#include <nba/bus/bus.hpp>
+
+namespace nba::core {
+
+void Bus::AddWatchpoint(u32 address, u32 size, int kind) {
+  watchpoints.push_back({address, size, kind});
+  UpdatePageTable();
+}
+
+void Bus::RemoveWatchpoint(u32 address) {
+  std::erase_if(watchpoints, [&](Watchpoint const& watchpoint) {
+    return watchpoint.address == address;
+  });
+  UpdatePageTable();
+}
+
+void Bus::ClearWatchpoints() {
+  watchpoints.clear();
+  UpdatePageTable();
+}
+
+void Bus::SetAccessTracing(bool enable) {
+  access_tracing = enable;
+  UpdatePageTable();
+}
+
+void Bus::OnWatchedAccess(u32 address, u64 timestamp, int size, u32 value, MemoryAccess::Kind kind, int access) {
+  if(!access_tracing) {
+    const bool hit = std::any_of(watchpoints.begin(), watchpoints.end(), [&](Watchpoint const& watchpoint) {
+      return (watchpoint.kind & kind) != 0 &&
+             (u64)address < (u64)watchpoint.address + std::max(watchpoint.size, 1u) &&
+             (u64)watchpoint.address < (u64)address + size;
+    });
+
+    if(!hit) {
+      return;
+    }
+  }
+
+  access_trace.Push({
+    .timestamp = timestamp,
+    .pc = hw.cpu.state.r15,
+    .address = address,
+    .value = value,
+    .size = (u8)size,
+    .kind = kind,
+    .access = (u8)access
+  });
+}
+
+} // namespace nba::core
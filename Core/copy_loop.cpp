@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <nba/emulator.hpp>
+
+namespace nba::core {
+
+namespace {
+
+/**
+ * A block copy (or fill) loop of the form:
+ *
+ *   loop:
+ *     LDMIA src!, {rlist}   @ omitted for fill loops
+ *     STMIA dst!, {rlist}
+ *     SUBS  counter, counter, #decrement
+ *     B<cc> loop
+ */
+struct CopyLoop {
+  int src = -1;
+  int dst;
+  int counter;
+  u16 list;
+  u32 decrement;
+  int condition;
+};
+
+auto ConditionPassed(int condition, bool n, bool z, bool c, bool v) -> bool {
+  switch(condition) {
+    case arm::COND_EQ: return z;
+    case arm::COND_NE: return !z;
+    case arm::COND_CS: return c;
+    case arm::COND_CC: return !c;
+    case arm::COND_MI: return n;
+    case arm::COND_PL: return !n;
+    case arm::COND_VS: return v;
+    case arm::COND_VC: return !v;
+    case arm::COND_HI: return c && !z;
+    case arm::COND_LS: return !c || z;
+    case arm::COND_GE: return n == v;
+    case arm::COND_LT: return n != v;
+    case arm::COND_GT: return !z && n == v;
+    case arm::COND_LE: return z || n != v;
+  }
+  return true;
+}
+
+auto IsValid(CopyLoop const& loop) -> bool {
+  u32 used = (1 << loop.dst) | (1 << loop.counter) | (1 << 15);
+
+  if(loop.src != -1) {
+    if(loop.src == loop.dst) {
+      return false;
+    }
+    used |= 1 << loop.src;
+  }
+
+  return loop.list != 0 && (loop.list & used) == 0 &&
+         loop.dst != loop.counter && loop.src != loop.counter &&
+         loop.decrement != 0 && loop.condition < arm::COND_AL;
+}
+
+auto DecodeARM(u32 const* code, int length, CopyLoop& loop) -> bool {
+  int i = 0;
+
+  if(length == 4) {
+    // LDMIA src!, {rlist}
+    if((code[0] & 0xFFF00000) != 0xE8B00000) {
+      return false;
+    }
+    loop.src = (code[0] >> 16) & 15;
+    loop.list = code[0] & 0xFFFF;
+    i++;
+  }
+
+  // STMIA dst!, {rlist}
+  if((code[i] & 0xFFF00000) != 0xE8A00000 || (loop.src != -1 && (code[i] & 0xFFFF) != loop.list)) {
+    return false;
+  }
+  loop.dst = (code[i] >> 16) & 15;
+  loop.list = code[i] & 0xFFFF;
+
+  // SUBS counter, counter, #imm
+  const u32 sub = code[i + 1];
+  if((sub & 0xFFF00000) != 0xE2500000 || ((sub >> 16) & 15) != ((sub >> 12) & 15)) {
+    return false;
+  }
+  loop.counter = (sub >> 12) & 15;
+  loop.decrement = std::rotr(sub & 0xFF, ((sub >> 8) & 15) * 2);
+
+  // B<cc> loop (the branch target has been checked by the caller)
+  const u32 branch = code[i + 2];
+  if((branch & 0x0F000000) != 0x0A000000) {
+    return false;
+  }
+  loop.condition = branch >> 28;
+
+  return IsValid(loop);
+}
+
+auto DecodeThumb(u16 const* code, int length, CopyLoop& loop) -> bool {
+  int i = 0;
+
+  if(length == 4) {
+    // LDMIA src!, {rlist}
+    if((code[0] & 0xF800) != 0xC800) {
+      return false;
+    }
+    loop.src = (code[0] >> 8) & 7;
+    loop.list = code[0] & 0xFF;
+    i++;
+  }
+
+  // STMIA dst!, {rlist}
+  if((code[i] & 0xF800) != 0xC000 || (loop.src != -1 && (code[i] & 0xFF) != loop.list)) {
+    return false;
+  }
+  loop.dst = (code[i] >> 8) & 7;
+  loop.list = code[i] & 0xFF;
+
+  // SUB counter, #imm8 or SUB counter, counter, #imm3
+  const u16 sub = code[i + 1];
+  if((sub & 0xF800) == 0x3800) {
+    loop.counter = (sub >> 8) & 7;
+    loop.decrement = sub & 0xFF;
+  } else if((sub & 0xFE00) == 0x1E00 && (sub & 7) == ((sub >> 3) & 7)) {
+    loop.counter = sub & 7;
+    loop.decrement = (sub >> 6) & 7;
+  } else {
+    return false;
+  }
+
+  // B<cc> loop
+  const u16 branch = code[i + 2];
+  if((branch & 0xF000) != 0xD000) {
+    return false;
+  }
+  loop.condition = (branch >> 8) & 15;
+
+  return IsValid(loop);
+}
+
+} // anonymous namespace
+
+void Core::FuseCopyLoop(u32 address_lo, u32 address_hi, bool thumb, u64 timestamp_limit) {
+  using HaltControl = Bus::Hardware::HaltControl;
+
+  const u32 width = thumb ? sizeof(u16) : sizeof(u32);
+  const int length = (address_hi - address_lo) / width + 1;
+  const u32 code_page = address_lo >> 24;
+
+  // Code fetches from ROM interact with the prefetch buffer, so only loops in work RAM are handled.
+  if((code_page != 0x02 && code_page != 0x03) || length < 3 || length > 4) {
+    return;
+  }
+
+  CopyLoop loop;
+
+  if(thumb) {
+    auto code = bus.GetHostAddress<u16>(address_lo, length);
+    if(code == nullptr || !DecodeThumb(code, length, loop)) {
+      return;
+    }
+  } else {
+    auto code = bus.GetHostAddress<u32>(address_lo, length);
+    if(code == nullptr || !DecodeARM(code, length, loop)) {
+      return;
+    }
+  }
+
+  auto& state = cpu.state;
+
+  const bool copy = loop.src != -1;
+  const u32 block_size = std::popcount(loop.list) * sizeof(u32);
+  const u32 src = copy ? state.reg[loop.src] : 0;
+  const u32 dst = state.reg[loop.dst];
+  const u32 counter = state.reg[loop.counter];
+
+  if(((src | dst) & 3) != 0 || cpu.IRQLine() || dma.IsRunning()) {
+    return;
+  }
+
+  /* Run one iteration in the interpreter to learn how many cycles it takes.
+   * Subsequent iterations take the same time as long as no scheduler event fires,
+   * since all memory regions that we allow have fixed access timings.
+   */
+  const u64 timestamp_start = scheduler.GetTimestampNow();
+  const u64 timestamp_event = scheduler.GetTimestampTarget();
+  const auto mode = state.cpsr.f.mode;
+
+  for(int i = 0; i < length; i++) {
+    if(scheduler.GetTimestampNow() >= timestamp_limit) {
+      return;
+    }
+    cpu.Run();
+  }
+
+  const u64 timestamp_now = scheduler.GetTimestampNow();
+
+  if(state.r15 != address_lo + 2 * width ||
+     state.cpsr.f.mode != mode ||
+     state.cpsr.f.thumb != thumb ||
+     (copy && state.reg[loop.src] != src + block_size) ||
+     state.reg[loop.dst] != dst + block_size ||
+     state.reg[loop.counter] != counter - loop.decrement ||
+     timestamp_now >= timestamp_event ||
+     timestamp_now >= timestamp_limit ||
+     bus.hw.haltcnt != HaltControl::Run ||
+     cpu.IRQLine() || dma.IsRunning()) {
+    return;
+  }
+
+  const int cycles_per_iteration = (int)(timestamp_now - timestamp_start);
+
+  // Stop short of the next scheduler event and the end of the current Run() call.
+  const u64 budget = std::min(timestamp_event - 1, timestamp_limit) - timestamp_now;
+  const u64 max_iterations = budget / cycles_per_iteration;
+
+  u32 value = state.reg[loop.counter];
+  u32 iterations = 0;
+  u32 flags = state.cpsr.v;
+
+  // The last iteration, which falls through the branch, is left to the interpreter.
+  while(iterations < max_iterations) {
+    const u32 result = value - loop.decrement;
+    const bool n = result >> 31;
+    const bool z = result == 0;
+    const bool c = value >= loop.decrement;
+    const bool v = ((value ^ loop.decrement) & (value ^ result)) >> 31;
+
+    if(!ConditionPassed(loop.condition, n, z, c, v)) {
+      break;
+    }
+
+    value = result;
+    flags = (flags & 0x0FFFFFFF) | ((u32)n << 31) | ((u32)z << 30) | ((u32)c << 29) | ((u32)v << 28);
+    iterations++;
+  }
+
+  if(iterations == 0) {
+    return;
+  }
+
+  const u32 size = iterations * block_size;
+  const u32 src_address = copy ? state.reg[loop.src] : 0;
+  const u32 dst_address = state.reg[loop.dst];
+
+  // The PPU does not fetch from VRAM between the end of scanline 159 and the start of scanline 227.
+  const bool vram_is_idle = ppu.mmio.vcount >= 160 && ppu.mmio.vcount < 227;
+
+  const auto GetDestination = [&](u32 address) -> u8* {
+    switch(address >> 24) {
+      case 0x02:
+      case 0x03:
+        return bus.GetWritableHostAddress<u8>(address, size);
+      case 0x06:
+        return vram_is_idle ? bus.GetWritableHostAddress<u8>(address, size) : nullptr;
+    }
+    return nullptr;
+  };
+
+  const auto GetSource = [&](u32 address) -> u8 const* {
+    switch(address >> 24) {
+      case 0x02:
+      case 0x03:
+        return bus.GetHostAddress<u8>(address, size);
+      case 0x06:
+        return vram_is_idle ? bus.GetHostAddress<u8>(address, size) : nullptr;
+      case 0x08 ... 0x0C: {
+        // Reads must stay clear of the GPIO port and must not cross a 128 KiB boundary,
+        // which would force a non-sequential access.
+        const bool hits_gpio = address < 0x080000CA && address + size > 0x080000C4;
+        const bool crosses_boundary = ((address ^ (address + size - 1)) >> 17) != 0;
+
+        if(hits_gpio || crosses_boundary) {
+          return nullptr;
+        }
+        return bus.GetHostAddress<u8>(address, size);
+      }
+    }
+    return nullptr;
+  };
+
+  u8* dst_host = GetDestination(dst_address);
+  u8 const* src_host = copy ? GetSource(src_address) : nullptr;
+
+  if(dst_host == nullptr || (copy && src_host == nullptr)) {
+    return;
+  }
+
+  // Do not overwrite the loop itself or the opcode prefetched behind the branch.
+  const u32 code_end = address_hi + 3 * width;
+
+  if(dst_address < code_end && dst_address + size > address_lo) {
+    return;
+  }
+
+  const int count = (int)(block_size / sizeof(u32));
+
+  u32 data[16];
+  int regs[16];
+
+  for(int i = 0, reg = 0; reg < 16; reg++) {
+    if(loop.list & (1 << reg)) regs[i++] = reg;
+  }
+
+  for(int i = 0; i < count; i++) {
+    data[i] = state.reg[regs[i]];
+  }
+
+  for(u32 offset = 0; offset < size; offset += block_size) {
+    // Copy block by block so that overlapping ranges behave like the original loop.
+    if(copy) {
+      std::memcpy(data, src_host + offset, block_size);
+    }
+    std::memcpy(dst_host + offset, data, block_size);
+  }
+
+  for(int i = 0; i < count; i++) {
+    state.reg[regs[i]] = data[i];
+  }
+
+  if(copy) {
+    state.reg[loop.src] += size;
+  }
+  state.reg[loop.dst] += size;
+  state.reg[loop.counter] = value;
+  state.cpsr.v = flags;
+
+  // The prefetch unit catches up with the skipped cycles by itself (see Bus::SyncPrefetch).
+  bus.Step((int)(iterations * cycles_per_iteration));
+
+  statistics.copy_loop_iterations_fused += iterations;
+}
+
+} // namespace nba::core
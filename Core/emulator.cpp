@@ -5,6 +5,7 @@
  * Refer to the included LICENSE file.
  */
 
+#include <chrono>
 #include <nba/common/crc32.hpp>
 #include <nba/rom/gpio/rtc.hpp>
 #include <nba/rom/gpio/solar_sensor.hpp>
@@ -24,11 +25,13 @@ Core::Core(std::shared_ptr<Config> config)
     , ppu(scheduler, irq, dma, config)
     , timer(scheduler, irq, apu)
     , keypad(scheduler, irq)
-    , bus(scheduler, {cpu, irq, dma, apu, ppu, timer, keypad}) {
+    , bus(scheduler, {cpu, irq, dma, apu, ppu, timer, keypad})
+    , bios_hle(cpu, bus) {
   Reset();
 }
 
 void Core::Reset() {
+  idle_loop_cache.clear();
   scheduler.Reset();
   cpu.Reset();
   irq.Reset();
@@ -38,29 +41,52 @@ void Core::Reset() {
   ppu.Reset();
   bus.Reset();
   keypad.Reset();
+  bios_hle.Reset();
 
-  if(config->skip_bios) {
+  // Without a BIOS image fall back to the replacement BIOS, which cannot show the boot screen.
+  const bool use_bios_stub = config->bios_hle_enable && !has_bios;
+
+  if(use_bios_stub) {
+    bus.Attach(BIOSHLE::GetStubImage());
+  }
+
+  bios_hle.UseStubBIOS() = use_bios_stub;
+  cpu.SetBIOSHLE(config->bios_hle_enable ? &bios_hle : nullptr);
+
+  if(config->skip_bios || use_bios_stub) {
     SkipBootScreen();
   }
 
+  hle_audio_hook = 0xFFFFFFFF;
+  hle_audio_hook_pending = false;
+
   if(config->audio.mp2k_hle_enable) {
     apu.GetMP2K().UseCubicFilter() = config->audio.mp2k_hle_cubic;
     apu.GetMP2K().ForceReverb() = config->audio.mp2k_hle_force_reverb;
-    hle_audio_hook = SearchSoundMainRAM();
-    if(hle_audio_hook != 0xFFFFFFFF) {
-      Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", hle_audio_hook);
+
+    // The ROM does not change on reset, so a previous search result can be reused.
+    if(!sound_main_ram_search.valid()) {
+      SearchSoundMainRAMAsync();
     }
-  } else {
-    hle_audio_hook = 0xFFFFFFFF;
+    hle_audio_hook_pending = true;
   }
 }
 
 void Core::Attach(std::vector<u8> const& bios) {
   bus.Attach(bios);
+  has_bios = true;
 }
 
 void Core::Attach(ROM&& rom) {
+  idle_loop_cache.clear();
+  statistics = {};
   bus.Attach(std::move(rom));
+
+  sound_main_ram_search = {};
+
+  if(config->audio.mp2k_hle_enable) {
+    SearchSoundMainRAMAsync();
+  }
 }
 
 auto Core::CreateRTC() -> std::unique_ptr<RTC> {
@@ -79,19 +105,37 @@ void Core::Run(int cycles) {
   using HaltControl = Bus::Hardware::HaltControl;
 
   const auto limit = scheduler.GetTimestampNow() + cycles;
+  // Skipped and fused loops do not perform their accesses one by one, so watchpoints would miss them.
+  const bool detect_loops = (config->skip_idle_loops || config->fuse_copy_loops) && !bus.IsWatching();
+
+  /* The search for the MP2K mixer runs in the background. Until it is done, the mixer
+   * (if any) is interpreted, so that the first frames do not wait for the scan of the ROM.
+   */
+  if(hle_audio_hook_pending && sound_main_ram_search.wait_for(std::chrono::seconds{0}) == std::future_status::ready) {
+    hle_audio_hook = sound_main_ram_search.get();
+    hle_audio_hook_pending = false;
+
+    if(hle_audio_hook != 0xFFFFFFFF) {
+      Log<Info>("Core: detected MP2K audio mixer @ 0x{:08X}", hle_audio_hook);
+    }
+  }
 
   while(scheduler.GetTimestampNow() < limit) {
     if(bus.hw.haltcnt == HaltControl::Run) {
       if(cpu.state.r15 == hle_audio_hook) {
-        const u32  sound_info_addr = *bus.GetHostAddress<u32>(0x03007FF0);
-        const auto sound_info = bus.GetHostAddress<MP2K::SoundInfo>(sound_info_addr);
+        const u32  sound_info_addr = *bus.Translate<u32>(sound_info_pointer_translation, 0x03007FF0);
+        const auto sound_info = bus.Translate<MP2K::SoundInfo>(sound_info_translation, sound_info_addr);
 
         if(sound_info != nullptr) {
           apu.GetMP2K().SoundMainRAM(*sound_info);
         }
       }
 
-      cpu.Run();
+      if(detect_loops) {
+        RunAndDetectLoop(limit);
+      } else {
+        cpu.Run();
+      }
     } else {
       while(scheduler.GetTimestampNow() < limit && !irq.ShouldUnhaltCPU()) {
         if(dma.IsRunning()) {
@@ -110,6 +154,45 @@ void Core::Run(int cycles) {
   }
 }
 
+void Core::RunAndDetectLoop(u64 timestamp_limit) {
+  // Longest loop (in instructions) that we consider for idle loop detection.
+  static constexpr int kMaxIdleLoopLength = 8;
+
+  const bool thumb = cpu.state.cpsr.f.thumb;
+  const auto mode = cpu.state.cpsr.f.mode;
+  const u32 r15 = cpu.state.r15;
+
+  cpu.Run();
+
+  // Check if the CPU took a short backward branch (and did not enter an exception).
+  const u32 width = thumb ? sizeof(u16) : sizeof(u32);
+  const u32 distance = r15 - cpu.state.r15;
+
+  if(distance >= kMaxIdleLoopLength * width ||
+     cpu.state.cpsr.f.thumb != thumb ||
+     cpu.state.cpsr.f.mode != mode) {
+    return;
+  }
+
+  const u32 address_lo = cpu.state.r15 - 2 * width;
+  const u32 address_hi = r15 - 2 * width;
+
+  /* The loop cannot make progress until the next scheduler event, unless an
+   * IRQ is about to be taken or a DMA is about to modify memory.
+   */
+  if(config->skip_idle_loops && !cpu.IRQLine() && !dma.IsRunning() && IsIdleLoop(address_lo, address_hi, thumb)) {
+    const int skipped_cycles = scheduler.GetRemainingCycleCount();
+
+    bus.Step(skipped_cycles);
+    statistics.idle_loop_cycles_skipped += skipped_cycles;
+    return;
+  }
+
+  if(config->fuse_copy_loops) {
+    FuseCopyLoop(address_lo, address_hi, thumb, timestamp_limit);
+  }
+}
+
 void Core::SkipBootScreen() {
   cpu.SwitchMode(arm::MODE_SYS);
   cpu.state.bank[arm::BANK_SVC][arm::BANK_R13] = 0x03007FE0;
@@ -118,12 +201,20 @@ void Core::SkipBootScreen() {
   cpu.state.r15 = 0x08000000;
 }
 
-auto Core::SearchSoundMainRAM() -> u32 {
+void Core::SearchSoundMainRAMAsync() {
+  /* Scanning the whole ROM takes a while and, for memory-mapped ROMs, faults in every page.
+   * Doing this on a separate thread lets the frontend finish loading in the meantime.
+   * The thread holds a reference to the (read-only) ROM image, so it stays valid while we search.
+   */
+  sound_main_ram_search = std::async(std::launch::async, [image = bus.memory.rom.GetImage()]() {
+    return SearchSoundMainRAM({image.data.get(), image.size});
+  }).share();
+}
+
+auto Core::SearchSoundMainRAM(std::span<u8 const> rom) -> u32 {
   static constexpr u32 kSoundMainCRC32 = 0x27EA7FCF;
   static constexpr int kSoundMainLength = 48;
 
-  auto& rom = bus.memory.rom.GetRawROM();
-
   if(rom.size() < kSoundMainLength) {
     return 0xFFFFFFFF;
   }
@@ -168,6 +259,10 @@ auto Core::GetOAM() -> u8* {
   return ppu.GetOAM();
 }
 
+auto Core::GetHostSpan(u32 address, size_t size) -> std::span<u8 const> {
+  return bus.GetHostSpan(address, size);
+}
+
 auto Core::PeekByteIO(u32 address) -> u8  {
   return bus.hw.ReadByte(address);
 }
@@ -188,10 +283,38 @@ auto Core::GetBGVOFS(int id) -> u16 {
   return ppu.mmio.bgvofs[id];
 }
 
+auto Core::GetCPURegisters() -> arm::RegisterFile const& {
+  return cpu.state;
+}
+
 Scheduler& Core::GetScheduler() {
   return scheduler;
 }
 
+auto Core::GetStatistics() -> Statistics& {
+  return statistics;
+}
+
+void Core::AddWatchpoint(u32 address, u32 size, int kind) {
+  bus.AddWatchpoint(address, size, kind);
+}
+
+void Core::RemoveWatchpoint(u32 address) {
+  bus.RemoveWatchpoint(address);
+}
+
+void Core::ClearWatchpoints() {
+  bus.ClearWatchpoints();
+}
+
+void Core::SetAccessTracing(bool enable) {
+  bus.SetAccessTracing(enable);
+}
+
+auto Core::GetAccessTrace() -> AccessTrace& {
+  return bus.access_trace;
+}
+
 } // namespace nba::core
 
 auto CreateCore(
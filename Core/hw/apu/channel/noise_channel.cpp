@@ -14,7 +14,7 @@ NoiseChannel::NoiseChannel(Scheduler& scheduler, BIAS& bias)
     : BaseChannel(true, false)
     , scheduler(scheduler)
     , bias(bias) {
-  scheduler.Register(Scheduler::EventClass::APU_PSG4_generate, this, &NoiseChannel::Generate);
+  scheduler.Register<&NoiseChannel::Generate>(Scheduler::EventClass::APU_PSG4_generate, this);
   
   Reset();
 }
@@ -12,7 +12,7 @@ namespace nba::core {
 WaveChannel::WaveChannel(Scheduler& scheduler)
     : BaseChannel(false, false, 256)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::APU_PSG3_generate, this, &WaveChannel::Generate);
+  scheduler.Register<&WaveChannel::Generate>(Scheduler::EventClass::APU_PSG3_generate, this);
 
   Reset(WaveChannel::ResetWaveRAM::Yes);
 }
@@ -70,7 +70,7 @@ void MP2K::SoundMainRAM(SoundInfo const& sound_info) {
       }
       hq_envelope_volume[0] = U8ToFloat(channel.envelope_attack);
 
-      const Sampler::WaveInfo* const wave_info = bus.GetHostAddress<Sampler::WaveInfo>(channel.wave_address); 
+      const Sampler::WaveInfo* const wave_info = bus.Translate<Sampler::WaveInfo>(wave_translations[i].info, channel.wave_address);
       if(wave_info == nullptr) {
         Log<Warn>("MP2K: channel[{}] wave address is invalid: 0x{:08X}", channel.wave_address);
         channel.status = 0; // Disable channel, there is no good way to deal with this.
@@ -212,7 +212,7 @@ void MP2K::RenderFrame() {
         wave_size = (wave_size + 63) / 64;
       }
       const u32 wave_data_begin = channel.wave_address + sizeof(Sampler::WaveInfo);
-      sampler.wave_data = bus.GetHostAddress<u8>(wave_data_begin, wave_size);
+      sampler.wave_data = bus.Translate<u8>(wave_translations[i].data, wave_data_begin, wave_size);
       if(sampler.wave_data == nullptr) {
         Log<Warn>("MP2K: channel[{}] sample data has bad memory range 0x{:08X} - 0x{:08X}.", i, wave_data_begin, wave_data_begin + wave_size);
         channel.status = 0; // Disable channel, there is no good way to deal with this.
@@ -5,6 +5,8 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <nba/common/compiler.hpp>
 
 #include <nba/bus/bus.hpp>
@@ -72,7 +74,7 @@ DMA::DMA(Bus& bus, IRQ& irq, Scheduler& scheduler)
     : bus(bus)
     , irq(irq)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::DMA_activated, this, &DMA::OnActivated);
+  scheduler.Register<&DMA::OnActivated>(Scheduler::EventClass::DMA_activated, this);
 
   Reset();
 }
@@ -190,6 +192,10 @@ void DMA::RunChannel() {
       return;
     }
 
+    if(src_modify == dst_modify && src_modify > 0 && RunChannelBulk(channel, did_access_rom)) {
+      continue;
+    }
+
     auto src_addr = channel.latch.src_addr;
     auto dst_addr = channel.latch.dst_addr;
 
@@ -267,6 +273,136 @@ void DMA::RunChannel() {
   SelectNextDMA();
 }
 
+auto DMA::GetBulkRange(u32 address, bool word) -> BulkRange {
+  auto& ppu = bus.hw.ppu;
+  auto& memory = bus.memory;
+
+  const int page = address >> 24;
+
+  // Accesses to watched memory must be reported one by one.
+  if(bus.page_table[page].watched) {
+    return {};
+  }
+
+  switch(page) {
+    // EWRAM (external work RAM)
+    case 0x02: {
+      const u32 offset = address & 0x3FFFF;
+      return {memory.wram.data() + offset, memory.wram.data() + offset, 0x40000 - offset, word ? 6 : 3};
+    }
+    // IWRAM (internal work RAM)
+    case 0x03: {
+      const u32 offset = address & 0x7FFF;
+      return {memory.iram.data() + offset, memory.iram.data() + offset, 0x8000 - offset, 1};
+    }
+    // PRAM (palette RAM)
+    case 0x05: {
+      if(!ppu.IsIdlePRAM()) break;
+      const u32 offset = address & 0x3FF;
+      return {ppu.GetPRAM() + offset, ppu.GetPRAM() + offset, 0x400 - offset, word ? 2 : 1};
+    }
+    // VRAM (video RAM), except for the mirrored OBJ area
+    case 0x06: {
+      const u32 offset = address & 0x1FFFF;
+      if(offset >= 0x18000 || !ppu.IsIdleVRAM_BG() || !ppu.IsIdleVRAM_OBJ()) break;
+      return {ppu.GetVRAM() + offset, ppu.GetVRAM() + offset, 0x18000 - offset, word ? 2 : 1};
+    }
+    // OAM (object attribute map)
+    case 0x07: {
+      if(!ppu.IsIdleOAM()) break;
+      const u32 offset = address & 0x3FF;
+      return {ppu.GetOAM() + offset, ppu.GetOAM() + offset, 0x400 - offset, 1};
+    }
+    // ROM (WS0, WS1, WS2): sequential reads up to the next 128 KiB boundary, away from GPIO and EEPROM
+    case 0x08 ... 0x0D: {
+      auto const& entry = bus.page_table[page];
+      const u32 offset = address & 0x01FF'FFFF;
+      if(entry.type != Bus::Page::Type::ROM || offset < entry.begin || offset >= entry.end ||
+         (offset & 0x1FFFF) == 0 || bus.prefetch.active) {
+        break;
+      }
+      const u32 size = std::min(entry.end, (offset | 0x1FFFF) + 1) - offset;
+      return {entry.data + offset, nullptr, size, word ? bus.wait32[1][page] : bus.wait16[1][page]};
+    }
+  }
+
+  return {};
+}
+
+/**
+ * Transfers as many units as possible in one go, when both source and destination are plain memory
+ * that the DMA accesses at a fixed cost per unit. The transfer stops short of the next scheduler event,
+ * so that events (and the IRQs or DMAs they trigger) still happen at the right cycle.
+ * Returns false if the next unit has to go through the bus.
+ */
+bool DMA::RunChannelBulk(Channel& channel, bool did_access_rom) {
+  const bool word = channel.size == Channel::Word;
+  const u32 unit = word ? sizeof(u32) : sizeof(u16);
+
+  const u32 src_addr = channel.latch.src_addr;
+  const u32 dst_addr = channel.latch.dst_addr;
+
+  // The first ROM access of a transfer is non-sequential. ROM is never a valid destination.
+  if(src_addr < 0x02000000 || (src_addr >= 0x08000000 && !did_access_rom) || dst_addr >= 0x08000000) {
+    return false;
+  }
+
+  const auto src = GetBulkRange(src_addr, word);
+  const auto dst = GetBulkRange(dst_addr, word);
+
+  if(src.data == nullptr || dst.writable_data == nullptr) {
+    return false;
+  }
+
+  const int cycles_per_unit = src.cycles + dst.cycles;
+  const u64 cycles_until_event = scheduler.GetTimestampTarget() - scheduler.GetTimestampNow() - 1;
+
+  u32 count = channel.latch.length;
+  count = std::min(count, src.size / unit);
+  count = std::min(count, dst.size / unit);
+  count = (u32)std::min<u64>(count, cycles_until_event / cycles_per_unit);
+
+  if(count == 0) {
+    return false;
+  }
+
+  const u32 size = count * unit;
+
+  if(src.data + size <= dst.data || dst.data + size <= src.data) {
+    std::memcpy(dst.writable_data, src.data, size);
+  } else {
+    // Overlapping ranges must behave like the unit-by-unit transfer.
+    for(u32 offset = 0; offset < size; offset += unit) {
+      std::memmove(dst.writable_data + offset, src.data + offset, unit);
+    }
+  }
+
+  if((dst_addr >> 24) == 0x06) {
+    bus.hw.ppu.InvalidateTileCache(dst_addr & 0x1FFFF, size);
+  }
+
+  if(word) {
+    channel.latch.bus = read<u32>(dst.data, size - unit);
+  } else {
+    const u16 value = read<u16>(dst.data, size - unit);
+    channel.latch.bus = (value << 16) | value;
+  }
+  latch = channel.latch.bus;
+
+  if(src_addr >= 0x08000000) {
+    bus.memory.rom.SetAddressLatch((src_addr & 0x01FF'FFFF) + size);
+  }
+
+  bus.Step(count * cycles_per_unit);
+  bus.parallel_internal_cpu_cycle_limit = 0;
+  bus.last_access = Bus::Access::Sequential | Bus::Access::Dma;
+
+  channel.latch.src_addr += size;
+  channel.latch.dst_addr += size;
+  channel.latch.length -= count;
+  return true;
+}
+
 auto DMA::Read(int chan_id, int offset) -> u8 {
   auto const& channel = channels[chan_id];
 
@@ -19,9 +19,9 @@ namespace nba::core {
 IRQ::IRQ(arm::ARM7TDMI& cpu, Scheduler& scheduler)
     : cpu(cpu)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::IRQ_write_io, this, &IRQ::OnWriteIO);
-  scheduler.Register(Scheduler::EventClass::IRQ_update_ie_and_if, this, &IRQ::UpdateIEAndIF);
-  scheduler.Register(Scheduler::EventClass::IRQ_update_irq_line, this, &IRQ::UpdateIRQLine);
+  scheduler.Register<&IRQ::OnWriteIO>(Scheduler::EventClass::IRQ_write_io, this);
+  scheduler.Register<&IRQ::UpdateIEAndIF>(Scheduler::EventClass::IRQ_update_ie_and_if, this);
+  scheduler.Register<&IRQ::UpdateIRQLine>(Scheduler::EventClass::IRQ_update_irq_line, this);
 
   Reset();
 }
@@ -44,28 +44,204 @@ void PPU::InitBackground() {
 void PPU::DrawBackground() {
   const u64 timestamp_now = scheduler.GetTimestampNow();
   
-  const int cycles = (int)(timestamp_now - bg.timestamp_last_sync);
+  int cycles = (int)(timestamp_now - bg.timestamp_last_sync);
 
   if(cycles == 0 || bg.cycle >= 1232U) {
     return;
   }
 
-  const int mode = mmio.dispcnt.mode;
+  const auto Draw = [&](int cycles_to_draw) {
+    switch(mmio.dispcnt.mode) {
+      case 0: DrawBackgroundImpl<0>(cycles_to_draw); break;
+      case 1: DrawBackgroundImpl<1>(cycles_to_draw); break;
+      case 2: DrawBackgroundImpl<2>(cycles_to_draw); break;
+      case 3: DrawBackgroundImpl<3>(cycles_to_draw); break;
+      case 4: DrawBackgroundImpl<4>(cycles_to_draw); break;
+      case 5: DrawBackgroundImpl<5>(cycles_to_draw); break;
+      case 6: 
+      case 7: DrawBackgroundImpl<7>(cycles_to_draw); break;
+    }
+  };
+
+  if(config->video.scanline_renderer || skip_frame) {
+    // Draw the visible part of the line in one go, unless the PPU was synced earlier in this line.
+    if(bg.cycle == 0U && cycles >= 1006 && DrawBackgroundLine(!skip_frame)) {
+      cycles -= 1006;
+    }
+
+    /**
+     * During H-blank only the text-mode engines may still fetch the rest of their last tile.
+     * Once they are done, nothing happens until the mosaic and BG X/Y update in cycle 1232.
+     */
+    if(bg.cycle >= 1006U) {
+      const int cycles_until_idle = std::min(cycles, std::max(1040 - (int)bg.cycle, 0));
 
-  switch(mode) {
-    case 0: DrawBackgroundImpl<0>(cycles); break;
-    case 1: DrawBackgroundImpl<1>(cycles); break;
-    case 2: DrawBackgroundImpl<2>(cycles); break;
-    case 3: DrawBackgroundImpl<3>(cycles); break;
-    case 4: DrawBackgroundImpl<4>(cycles); break;
-    case 5: DrawBackgroundImpl<5>(cycles); break;
-    case 6: 
-    case 7: DrawBackgroundImpl<7>(cycles); break;
+      Draw(cycles_until_idle);
+      cycles -= cycles_until_idle;
+
+      if(std::all_of(std::begin(bg.text), std::end(bg.text), [](auto const& text) { return text.fetches == 0; })) {
+        const int cycles_idle = std::min(cycles, std::max(1231 - (int)bg.cycle, 0));
+
+        bg.cycle += cycles_idle;
+        cycles -= cycles_idle;
+      }
+    }
   }
 
+  Draw(cycles);
+
   bg.timestamp_last_sync = timestamp_now;
 }
 
+/**
+ * Draws the visible part of the line in one go. If render is false (in skipped frames)
+ * only the state of the engines is updated, as nothing will look at the pixels.
+ */
+bool PPU::DrawBackgroundLine(bool render) {
+  // The engines do not fetch from VRAM during forced blank, which the per-cycle path handles best.
+  if(ForcedBlank()) {
+    return false;
+  }
+
+  const u16 latched_dispcnt_and_current_dispcnt = mmio.dispcnt_latch[0] & mmio.dispcnt.hword;
+
+  const int mode = mmio.dispcnt.mode;
+
+  const auto IsTextBGEnabled = [&](uint id) {
+    return mode <= 1 && (id <= 1 || mode == 0) && (latched_dispcnt_and_current_dispcnt & (256U << id));
+  };
+
+  const auto IsAffineBGEnabled = [&](uint id) {
+    return (mode == 1 || mode == 2) && (id == 0 || mode == 2) && (latched_dispcnt_and_current_dispcnt & (1024U << id));
+  };
+
+  const bool bitmap_bg_enabled = mode >= 3 && mode <= 5 && (latched_dispcnt_and_current_dispcnt & 1024U);
+
+  if(render) {
+    for(uint id = 0; id < 4; id++) {
+      if(IsTextBGEnabled(id) && !RenderLineMode0BG(id)) {
+        return false;
+      }
+    }
+
+    for(uint id = 0; id < 2; id++) {
+      if(IsAffineBGEnabled(id)) {
+        RenderLineMode2BG(id);
+      }
+    }
+
+    if(bitmap_bg_enabled) {
+      switch(mode) {
+        case 3: RenderLineMode3BG(); break;
+        case 4: RenderLineMode4BG(); break;
+        case 5: RenderLineMode5BG(); break;
+      }
+    }
+  }
+
+  /**
+   * Bring the engines into the state that the per-cycle path would leave them in after cycle 1006.
+   * The text-mode engines keep fetching the last tile during H-blank and the VRAM latch must hold
+   * the last halfword fetched. So replay the cycles from the last text-mode map fetch (the last cycle < 1004
+   * where (cycle >> 2) + (BGHOFS mod 8) = 0 (mod 8)) and from the last affine map fetch onwards.
+   * Fetches of other engines before that are not replayed, but are followed by a replayed fetch.
+   */
+  uint replay_cycle[4];
+  uint first_replay_cycle = 1007U;
+  u32  text_pixel[4];
+
+  for(uint id = 0; id < 4; id++) {
+    if(IsTextBGEnabled(id)) {
+      const uint cycle_div_4 = 250U - ((250U + mmio.bghofs[id]) & 7U);
+
+      replay_cycle[id] = (cycle_div_4 << 2) + id;
+      first_replay_cycle = std::min(first_replay_cycle, replay_cycle[id]);
+
+      // The replay would output a pixel from a stale tile in its first cycle.
+      text_pixel[id] = bg.buffer[std::min(cycle_div_4 - 9U, 239U)][id];
+
+      bg.text[id].fetches = 0;
+    }
+  }
+
+  for(uint id = 0; id < 2; id++) {
+    if(IsAffineBGEnabled(id)) {
+      // The last map fetch is the 244th one (in cycle 1006 for BG2 and cycle 1004 for BG3).
+      bg.affine[id].x += 243 * mmio.bgpa[id];
+      bg.affine[id].y += 243 * mmio.bgpc[id];
+
+      first_replay_cycle = std::min(first_replay_cycle, 1004U);
+    }
+  }
+
+  for(uint cycle = first_replay_cycle; cycle < 1007U; cycle++) {
+    const uint text_id = cycle & 3U;
+    const uint affine_id = ~(cycle >> 1) & 1U;
+
+    if(IsTextBGEnabled(text_id) && cycle >= replay_cycle[text_id]) {
+      RenderMode0BG(text_id, cycle);
+    }
+
+    if(IsAffineBGEnabled(affine_id) && cycle >= 1004U) {
+      RenderMode2BG(affine_id, cycle);
+    }
+  }
+
+  for(uint id = 0; id < 4; id++) {
+    if(IsTextBGEnabled(id)) {
+      const uint screen_x = (replay_cycle[id] >> 2) - 9U;
+
+      if(screen_x < 240U) {
+        bg.buffer[screen_x][id] = text_pixel[id];
+      }
+    }
+  }
+
+  /**
+   * Bitmap fetches from the sprite VRAM area do not update the VRAM latch,
+   * so find the last pixel (in cycle 35 + 4 * X) that did update it.
+   */
+  if(bitmap_bg_enabled) {
+    const s32 x = bg.affine[0].x;
+    const s32 y = bg.affine[0].y;
+
+    for(int screen_x = 242; screen_x >= 0; screen_x--) {
+      const uint cycle = 35U + (screen_x << 2);
+
+      bg.affine[0].x = x + screen_x * mmio.bgpa[0];
+      bg.affine[0].y = y + screen_x * mmio.bgpc[0];
+
+      switch(mode) {
+        case 3: RenderMode3BG(cycle); break;
+        case 4: RenderMode4BG(cycle); break;
+        case 5: RenderMode5BG(cycle); break;
+      }
+
+      if(bg.timestamp_vram_access == bg.timestamp_init + cycle) {
+        break;
+      }
+    }
+  }
+
+  bg.cycle = 1006U;
+  return true;
+}
+
+void PPU::DecodeTile4BPP(uint tile) {
+  const u8* data = &vram[tile << 5];
+
+  for(uint y = 0; y < 8U; y++) {
+    for(uint x = 0; x < 8U; x++) {
+      const u8 index = (data[(y << 2) + (x >> 1)] >> ((x & 1U) << 2)) & 15U;
+
+      tile_cache.data[tile][0][y][x] = index;
+      tile_cache.data[tile][1][y][x ^ 7U] = index;
+    }
+  }
+
+  tile_cache.dirty[tile] = false;
+}
+
 template<int mode> void PPU::DrawBackgroundImpl(int cycles) {
   const u16 latched_dispcnt_and_current_dispcnt = mmio.dispcnt_latch[0] & mmio.dispcnt.hword;
   
@@ -7,6 +7,14 @@
 
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64)
+  #include <emmintrin.h>
+  #define NBA_PPU_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define NBA_PPU_NEON
+#endif
+
 #include <nba/hw/ppu/ppu.hpp>
 
 namespace nba::core {
@@ -40,13 +48,23 @@ void PPU::DrawMerge() {
     return;
   }
 
+  const bool whole_line = merge.cycle == 0U && cycles >= 1006;
+
+  // Draw the whole line in one go, unless the PPU was synced earlier in this line.
+  // In skipped frames such lines are not drawn at all, since nothing but the output depends on them.
   // @todo: possibly template this based on IO configuration
-  DrawMergeImpl(cycles);
+  if(whole_line && skip_frame) {
+    merge.cycle = 1006U;
+  } else if(whole_line && config->video.scanline_renderer) {
+    DrawMergeImpl<true>(cycles);
+  } else {
+    DrawMergeImpl<false>(cycles);
+  }
 
   merge.timestamp_last_sync = timestamp_now;
 }
 
-void PPU::DrawMergeImpl(int cycles) {
+template<bool whole_line> void PPU::DrawMergeImpl(int cycles) {
   static constexpr int k_min_max_bg[8][2] {
     {0,  3}, // Mode 0 (BG0 - BG3 text-mode)
     {0,  2}, // Mode 1 (BG0 - BG1 text-mode, BG2 affine)
@@ -90,16 +108,7 @@ void PPU::DrawMergeImpl(int cycles) {
   auto layers = merge.layers;
   auto colors = merge.colors;
 
-  for(int i = 0; i < cycles; i++) {
-    const int cycle = (int)merge.cycle - 46;
-
-    if(cycle < 0) {
-      merge.cycle++;
-      continue;
-    }
-
-    const uint x = (uint)cycle >> 2;
-
+  const auto SelectWindow = [&](uint x) {
     // @todo: optimize this, this is baaad
     if(have_windows) {
       if(enable_win0 && window.buffer[x][0]) {
@@ -112,154 +121,246 @@ void PPU::DrawMergeImpl(int cycles) {
         win_layer_enable = mmio.winout.enable[0];
       }
     }
+  };
 
-    const int phase = cycle & 3;
-
-    if(phase == 0) {
-      merge.forced_blank = ForcedBlank();
+  // Selects the top two layers of the pixel and fetches the color of the top layer.
+  const auto DrawPhase0 = [&](uint x) {
+    merge.forced_blank = ForcedBlank();
 
-      if(!merge.forced_blank) {
-        uint priorities[2] {3U, 3U};
+    if(!merge.forced_blank) {
+      uint priorities[2] {3U, 3U};
 
-        layers[0] = LAYER_BD;
-        layers[1] = LAYER_BD;
-        colors[0] = 0U;
-        colors[1] = 0U;
+      layers[0] = LAYER_BD;
+      layers[1] = LAYER_BD;
+      colors[0] = 0U;
+      colors[1] = 0U;
 
-        int bg_list_index = 0;
+      int bg_list_index = 0;
 
-        // @todo: avoid extracting the top two layers in cases where it is not necessary.
-        for(int j = 0; j < 2; j++) {
-          while(bg_list_index < bg_count) {
-            const int bg_id = bg_list[bg_list_index];
+      // @todo: avoid extracting the top two layers in cases where it is not necessary.
+      for(int j = 0; j < 2; j++) {
+        while(bg_list_index < bg_count) {
+          const int bg_id = bg_list[bg_list_index];
 
-            bg_list_index++;
+          bg_list_index++;
 
-            if(!have_windows || win_layer_enable[bg_id]) {
-              const auto& bgcnt = mmio.bgcnt[bg_id];
-              const uint mx = x - (bgcnt.mosaic_enable ? merge.mosaic_x[0] : 0U);
-              const u32 bg_color = bg.buffer[mx][bg_id];
+          if(!have_windows || win_layer_enable[bg_id]) {
+            const auto& bgcnt = mmio.bgcnt[bg_id];
+            const uint mx = x - (bgcnt.mosaic_enable ? merge.mosaic_x[0] : 0U);
+            const u32 bg_color = bg.buffer[mx][bg_id];
 
-              if(bg_color != 0U) {
-                layers[j] = bg_id;
-                colors[j] = bg_color;
-                priorities[j] = (uint)bgcnt.priority;
-                break;
-              }
+            if(bg_color != 0U) {
+              layers[j] = bg_id;
+              colors[j] = bg_color;
+              priorities[j] = (uint)bgcnt.priority;
+              break;
             }
           }
         }
+      }
 
-        merge.force_alpha_blend = false;
+      merge.force_alpha_blend = false;
 
-        const auto current_sprite_pixel = enable_obj ? sprite.buffer_rd[x] : Sprite::Pixel{0U};
+      const auto current_sprite_pixel = enable_obj ? sprite.buffer_rd[x] : Sprite::Pixel{0U};
 
-        if(!current_sprite_pixel.mosaic || !merge.sprite_pixel_latch.mosaic || merge.mosaic_x[1] == 0U) {
-          merge.sprite_pixel_latch = current_sprite_pixel;
-        }
+      if(!current_sprite_pixel.mosaic || !merge.sprite_pixel_latch.mosaic || merge.mosaic_x[1] == 0U) {
+        merge.sprite_pixel_latch = current_sprite_pixel;
+      }
 
-        if(enable_obj && (!have_windows || win_layer_enable[LAYER_OBJ])) {
-          const auto pixel = merge.sprite_pixel_latch;
-
-          if(pixel.color != 0U) {
-            if(pixel.priority <= priorities[0]) {
-              // We do not care about the priority at this point, so we do not update it.
-              layers[1] = layers[0];
-              colors[1] = colors[0];
-              layers[0] = LAYER_OBJ;
-              colors[0] = pixel.color | 256U;
-
-              merge.force_alpha_blend = pixel.alpha;
-            } else if(pixel.priority <= priorities[1]) {
-              // We do not care about the priority at this point, so we do not update it.
-              layers[1] = LAYER_OBJ;
-              colors[1] = pixel.color | 256U;
-            }
+      if(enable_obj && (!have_windows || win_layer_enable[LAYER_OBJ])) {
+        const auto pixel = merge.sprite_pixel_latch;
+
+        if(pixel.color != 0U) {
+          if(pixel.priority <= priorities[0]) {
+            // We do not care about the priority at this point, so we do not update it.
+            layers[1] = layers[0];
+            colors[1] = colors[0];
+            layers[0] = LAYER_OBJ;
+            colors[0] = pixel.color | 256U;
+
+            merge.force_alpha_blend = pixel.alpha;
+          } else if(pixel.priority <= priorities[1]) {
+            // We do not care about the priority at this point, so we do not update it.
+            layers[1] = LAYER_OBJ;
+            colors[1] = pixel.color | 256U;
           }
         }
+      }
 
-        // @todo: make it clear what the meaning of 0x8000'0000 is.
-        if((colors[0] & 0x8000'0000) == 0) {
-          colors[0] = FetchPRAM(merge.cycle, colors[0] << 1);
-        }
-      } else {
-        colors[0] = 0x7FFFU; // output white
+      // @todo: make it clear what the meaning of 0x8000'0000 is.
+      if((colors[0] & 0x8000'0000) == 0) {
+        colors[0] = FetchPRAM(merge.cycle, colors[0] << 1);
       }
-    } else if(phase == 2) {
-      if(!merge.forced_blank) {
-        const bool have_src = mmio.bldcnt.targets[1][layers[1]];
-
-        if(merge.force_alpha_blend && have_src) {
-          // @todo: make it clear what the meaning of 0x8000'0000 is.
-          if((colors[1] & 0x8000'0000) == 0) {
-            colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
-          }
+    } else {
+      colors[0] = 0x7FFFU; // output white
+    }
+  };
 
-          colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
-        } else if(!have_windows || win_layer_enable[LAYER_SFX]) {
-          const bool have_dst = mmio.bldcnt.targets[0][layers[0]];
+  // Selects the color special effect of the pixel and fetches the color of the bottom layer, if it is needed.
+  const auto SelectEffect = [&]() -> Effect {
+    if(merge.forced_blank) {
+      return EFFECT_NONE;
+    }
 
-          switch(mmio.bldcnt.sfx) {
-            case BlendControl::SFX_BLEND: {
-              if(have_dst && have_src) {
-                // @todo: make it clear what the meaning of 0x8000'0000 is.
-                if((colors[1] & 0x8000'0000) == 0) {
-                  colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
-                }
+    const bool have_src = mmio.bldcnt.targets[1][layers[1]];
 
-                colors[0] = Blend(colors[0], colors[1], mmio.eva, mmio.evb);
-              }
-              break;
-            }
-            case BlendControl::SFX_BRIGHTEN: {
-              if(have_dst) {
-                colors[0] = Brighten(colors[0], mmio.evy);
-              }
-              break;
-            }
-            case BlendControl::SFX_DARKEN: {
-              if(have_dst) {
-                colors[0] = Darken(colors[0], mmio.evy);
-              }
-              break;
-            }
+    const auto FetchSrc = [&]() {
+      // @todo: make it clear what the meaning of 0x8000'0000 is.
+      if((colors[1] & 0x8000'0000) == 0) {
+        colors[1] = FetchPRAM(merge.cycle, colors[1] << 1);
+      }
+    };
+
+    if(merge.force_alpha_blend && have_src) {
+      FetchSrc();
+      return EFFECT_BLEND;
+    }
+
+    if(!have_windows || win_layer_enable[LAYER_SFX]) {
+      const bool have_dst = mmio.bldcnt.targets[0][layers[0]];
+
+      switch(mmio.bldcnt.sfx) {
+        case BlendControl::SFX_BLEND: {
+          if(have_dst && have_src) {
+            FetchSrc();
+            return EFFECT_BLEND;
+          }
+          break;
+        }
+        case BlendControl::SFX_BRIGHTEN: {
+          if(have_dst) {
+            return EFFECT_BRIGHTEN;
           }
+          break;
+        }
+        case BlendControl::SFX_DARKEN: {
+          if(have_dst) {
+            return EFFECT_DARKEN;
+          }
+          break;
         }
       }
+    }
 
-      if(x & 1) {
-        u16 color_l = merge.color_l;
-        u16 color_r = colors[0];
+    return EFFECT_NONE;
+  };
 
-        if(mmio.greenswap & 1) {
-          const u16 mask = 31U << 5;
+  const auto AdvanceMosaic = [&]() {
+    if(++merge.mosaic_x[0] == (uint)mmio.mosaic.bg.size_x) {
+      merge.mosaic_x[0] = 0U;
+    }
 
-          u16 g_l = color_l & mask;
-          u16 g_r = color_r & mask;
+    if(++merge.mosaic_x[1] == (uint)mmio.mosaic.obj.size_x) {
+      merge.mosaic_x[1] = 0U;
+    }
+  };
 
-          color_l = (color_l & ~mask) | g_r;
-          color_r = (color_r & ~mask) | g_l;
-        }
+  const auto ApplyEffect = [&](Effect effect, u16 color_a, u16 color_b) -> u16 {
+    switch(effect) {
+      case EFFECT_BLEND:    return Blend(color_a, color_b, mmio.eva, mmio.evb);
+      case EFFECT_BRIGHTEN: return Brighten(color_a, mmio.evy);
+      case EFFECT_DARKEN:   return Darken(color_a, mmio.evy);
+      default:              return color_a;
+    }
+  };
 
-        u32* out = &output[frame][mmio.vcount * 240 + (x & ~1)];
+  // Applies color special effects and outputs the pixel.
+  const auto DrawPhase2 = [&](uint x) {
+    const Effect effect = SelectEffect();
 
-        out[0] = RGB555(color_l);
-        out[1] = RGB555(color_r);
-      } else {
-        merge.color_l = colors[0];
+    if(effect != EFFECT_NONE) {
+      colors[0] = ApplyEffect(effect, colors[0], colors[1]);
+    }
+
+    if(x & 1) {
+      u16 color_l = merge.color_l;
+      u16 color_r = colors[0];
+
+      if(mmio.greenswap & 1) {
+        const u16 mask = 31U << 5;
+
+        u16 g_l = color_l & mask;
+        u16 g_r = color_r & mask;
+
+        color_l = (color_l & ~mask) | g_r;
+        color_r = (color_r & ~mask) | g_l;
       }
 
-      if(++merge.mosaic_x[0] == (uint)mmio.mosaic.bg.size_x) {
-        merge.mosaic_x[0] = 0U;
+      u32* out = &output[frame][mmio.vcount * 240 + (x & ~1)];
+
+      out[0] = RGB555(color_l);
+      out[1] = RGB555(color_r);
+    } else {
+      merge.color_l = colors[0];
+    }
+
+    AdvanceMosaic();
+  };
+
+  if constexpr(whole_line) {
+    // Select the layers and effects of all pixels first (this also does the PRAM fetches),
+    // then apply the effects and convert the colors for the whole line at once.
+    // The selection stays scalar: it fetches each pixel from PRAM at that pixel's cycle and latches the OBJ mosaic,
+    // so only the compose step is vectorized.
+    u16 line_colors[2][240];
+    u8  line_effects[240];
+
+    for(uint x = 0; x < 240U; x++) {
+      SelectWindow(x);
+
+      merge.cycle = 46U + (x << 2);
+      DrawPhase0(x);
+
+      merge.cycle += 2U;
+      line_effects[x] = SelectEffect();
+      line_colors[0][x] = (u16)colors[0];
+      line_colors[1][x] = (u16)colors[1];
+
+      AdvanceMosaic();
+    }
+
+    ComposeLine(
+      line_colors[0],
+      line_colors[1],
+      line_effects,
+      mmio.eva,
+      mmio.evb,
+      mmio.evy,
+      mmio.greenswap & 1,
+      &output[frame][mmio.vcount * 240]
+    );
+
+    // Leave the merge state as it would be after drawing the line pixel by pixel.
+    merge.color_l = ApplyEffect((Effect)line_effects[238], line_colors[0][238], line_colors[1][238]);
+
+    if(line_effects[239] != EFFECT_NONE) {
+      colors[0] = ApplyEffect((Effect)line_effects[239], line_colors[0][239], line_colors[1][239]);
+    }
+
+    merge.cycle = 1006U;
+  } else {
+    for(int i = 0; i < cycles; i++) {
+      const int cycle = (int)merge.cycle - 46;
+
+      if(cycle < 0) {
+        merge.cycle++;
+        continue;
       }
 
-      if(++merge.mosaic_x[1] == (uint)mmio.mosaic.obj.size_x) {
-        merge.mosaic_x[1] = 0U;
+      const uint x = (uint)cycle >> 2;
+      const int phase = cycle & 3;
+
+      if(phase == 0) {
+        SelectWindow(x);
+        DrawPhase0(x);
+      } else if(phase == 2) {
+        SelectWindow(x);
+        DrawPhase2(x);
       }
-    }
 
-    if(++merge.cycle == 1006U) {
-      break;
+      if(++merge.cycle == 1006U) {
+        break;
+      }
     }
   }
 }
@@ -315,4 +416,226 @@ auto PPU::Darken(u16 color, int evy) -> u16 {
   return (u16)((b << 10) | (g << 5) | r);
 }
 
+/**
+ * Applies the selected color special effect to each pixel of a line,
+ * followed by the green swap and the conversion to 32-bit ARGB.
+ * The vectorized paths process eight pixels at a time and must produce
+ * exactly the same output as Blend(), Brighten(), Darken() and RGB555().
+ */
+void PPU::ComposeLine(
+  u16 const* colors_a,
+  u16 const* colors_b,
+  u8 const* effects,
+  int eva,
+  int evb,
+  int evy,
+  bool greenswap,
+  u32* out
+) {
+  eva = std::min<int>(16, eva);
+  evb = std::min<int>(16, evb);
+  evy = std::min<int>(16, evy);
+
+#if defined(NBA_PPU_SSE2)
+  const __m128i m31 = _mm_set1_epi16(31);
+  const __m128i m62 = _mm_set1_epi16(62);
+  const __m128i m63 = _mm_set1_epi16(63);
+  const __m128i green_mask = _mm_set1_epi16(31 << 5);
+  const __m128i alpha = _mm_set1_epi16((short)0xFF00);
+  const __m128i v_eva = _mm_set1_epi16((short)eva);
+  const __m128i v_evb = _mm_set1_epi16((short)evb);
+  const __m128i v_evy = _mm_set1_epi16((short)evy);
+  const __m128i v_7 = _mm_set1_epi16(7);
+  const __m128i v_8 = _mm_set1_epi16(8);
+  const __m128i v_zero = _mm_setzero_si128();
+
+  // Green is expanded to six bits, with bit 15 of the color as the least-significant bit.
+  const auto R = [&](__m128i color) { return _mm_and_si128(color, m31); };
+  const auto G = [&](__m128i color) { return _mm_or_si128(_mm_and_si128(_mm_srli_epi16(color, 4), m62), _mm_srli_epi16(color, 15)); };
+  const auto B = [&](__m128i color) { return _mm_and_si128(_mm_srli_epi16(color, 10), m31); };
+
+  const auto Pack = [&](__m128i r, __m128i g, __m128i b) {
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b, 10), _mm_slli_epi16(_mm_srli_epi16(g, 1), 5)), r);
+  };
+
+  const auto Select = [&](__m128i mask, __m128i a, __m128i b) {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+  };
+
+  for(int x = 0; x < 240; x += 8) {
+    const __m128i color_a = _mm_loadu_si128((__m128i const*)&colors_a[x]);
+    const __m128i color_b = _mm_loadu_si128((__m128i const*)&colors_b[x]);
+    const __m128i effect = _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i const*)&effects[x]), v_zero);
+
+    const __m128i r_a = R(color_a);
+    const __m128i g_a = G(color_a);
+    const __m128i b_a = B(color_a);
+
+    __m128i color = color_a;
+
+    if(_mm_movemask_epi8(_mm_cmpeq_epi16(effect, v_zero)) != 0xFFFF) {
+      const auto BlendChannel = [&](__m128i a, __m128i b, __m128i max) {
+        const __m128i sum = _mm_add_epi16(_mm_mullo_epi16(a, v_eva), _mm_mullo_epi16(b, v_evb));
+        return _mm_min_epi16(_mm_srli_epi16(_mm_add_epi16(sum, v_8), 4), max);
+      };
+
+      const auto BrightenChannel = [&](__m128i a, __m128i max) {
+        return _mm_add_epi16(a, _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(max, a), v_evy), v_8), 4));
+      };
+
+      const auto DarkenChannel = [&](__m128i a) {
+        return _mm_sub_epi16(a, _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, v_evy), v_7), 4));
+      };
+
+      const __m128i blended = Pack(
+        BlendChannel(r_a, R(color_b), m31),
+        BlendChannel(g_a, G(color_b), m63),
+        BlendChannel(b_a, B(color_b), m31)
+      );
+      const __m128i brightened = Pack(BrightenChannel(r_a, m31), BrightenChannel(g_a, m63), BrightenChannel(b_a, m31));
+      const __m128i darkened = Pack(DarkenChannel(r_a), DarkenChannel(g_a), DarkenChannel(b_a));
+
+      color = Select(_mm_cmpeq_epi16(effect, _mm_set1_epi16(EFFECT_BLEND)), blended, color);
+      color = Select(_mm_cmpeq_epi16(effect, _mm_set1_epi16(EFFECT_BRIGHTEN)), brightened, color);
+      color = Select(_mm_cmpeq_epi16(effect, _mm_set1_epi16(EFFECT_DARKEN)), darkened, color);
+    }
+
+    if(greenswap) {
+      const __m128i swapped = _mm_shufflehi_epi16(_mm_shufflelo_epi16(color, 0xB1), 0xB1);
+
+      color = Select(green_mask, swapped, color);
+    }
+
+    // Expand each channel to eight bits and build the 0xFFRR and 0xGGBB halves of each pixel.
+    const auto Expand = [&](__m128i c) { return _mm_or_si128(_mm_slli_epi16(c, 3), _mm_srli_epi16(c, 2)); };
+
+    const __m128i r8 = Expand(R(color));
+    const __m128i g8 = Expand(_mm_and_si128(_mm_srli_epi16(color, 5), m31));
+    const __m128i b8 = Expand(B(color));
+
+    const __m128i hi = _mm_or_si128(alpha, r8);
+    const __m128i lo = _mm_or_si128(_mm_slli_epi16(g8, 8), b8);
+
+    _mm_storeu_si128((__m128i*)&out[x + 0], _mm_unpacklo_epi16(lo, hi));
+    _mm_storeu_si128((__m128i*)&out[x + 4], _mm_unpackhi_epi16(lo, hi));
+  }
+#elif defined(NBA_PPU_NEON)
+  const uint16x8_t m31 = vdupq_n_u16(31);
+  const uint16x8_t m62 = vdupq_n_u16(62);
+  const uint16x8_t m63 = vdupq_n_u16(63);
+  const uint16x8_t green_mask = vdupq_n_u16(31 << 5);
+  const uint16x8_t alpha = vdupq_n_u16(0xFF00);
+  const uint16x8_t v_7 = vdupq_n_u16(7);
+  const uint16x8_t v_8 = vdupq_n_u16(8);
+
+  // Green is expanded to six bits, with bit 15 of the color as the least-significant bit.
+  const auto R = [&](uint16x8_t color) { return vandq_u16(color, m31); };
+  const auto G = [&](uint16x8_t color) { return vorrq_u16(vandq_u16(vshrq_n_u16(color, 4), m62), vshrq_n_u16(color, 15)); };
+  const auto B = [&](uint16x8_t color) { return vandq_u16(vshrq_n_u16(color, 10), m31); };
+
+  const auto Pack = [&](uint16x8_t r, uint16x8_t g, uint16x8_t b) {
+    return vorrq_u16(vorrq_u16(vshlq_n_u16(b, 10), vshlq_n_u16(vshrq_n_u16(g, 1), 5)), r);
+  };
+
+  for(int x = 0; x < 240; x += 8) {
+    const uint16x8_t color_a = vld1q_u16(&colors_a[x]);
+    const uint16x8_t color_b = vld1q_u16(&colors_b[x]);
+    const uint16x8_t effect = vmovl_u8(vld1_u8(&effects[x]));
+
+    const uint16x8_t r_a = R(color_a);
+    const uint16x8_t g_a = G(color_a);
+    const uint16x8_t b_a = B(color_a);
+
+    uint16x8_t color = color_a;
+
+    if(vmaxvq_u16(effect) != EFFECT_NONE) {
+      const auto BlendChannel = [&](uint16x8_t a, uint16x8_t b, uint16x8_t max) {
+        const uint16x8_t sum = vmlaq_n_u16(vmulq_n_u16(a, (u16)eva), b, (u16)evb);
+        return vminq_u16(vshrq_n_u16(vaddq_u16(sum, v_8), 4), max);
+      };
+
+      const auto BrightenChannel = [&](uint16x8_t a, uint16x8_t max) {
+        return vaddq_u16(a, vshrq_n_u16(vmlaq_n_u16(v_8, vsubq_u16(max, a), (u16)evy), 4));
+      };
+
+      const auto DarkenChannel = [&](uint16x8_t a) {
+        return vsubq_u16(a, vshrq_n_u16(vmlaq_n_u16(v_7, a, (u16)evy), 4));
+      };
+
+      const uint16x8_t blended = Pack(
+        BlendChannel(r_a, R(color_b), m31),
+        BlendChannel(g_a, G(color_b), m63),
+        BlendChannel(b_a, B(color_b), m31)
+      );
+      const uint16x8_t brightened = Pack(BrightenChannel(r_a, m31), BrightenChannel(g_a, m63), BrightenChannel(b_a, m31));
+      const uint16x8_t darkened = Pack(DarkenChannel(r_a), DarkenChannel(g_a), DarkenChannel(b_a));
+
+      color = vbslq_u16(vceqq_u16(effect, vdupq_n_u16(EFFECT_BLEND)), blended, color);
+      color = vbslq_u16(vceqq_u16(effect, vdupq_n_u16(EFFECT_BRIGHTEN)), brightened, color);
+      color = vbslq_u16(vceqq_u16(effect, vdupq_n_u16(EFFECT_DARKEN)), darkened, color);
+    }
+
+    if(greenswap) {
+      color = vbslq_u16(green_mask, vrev32q_u16(color), color);
+    }
+
+    // Expand each channel to eight bits and build the 0xFFRR and 0xGGBB halves of each pixel.
+    const auto Expand = [&](uint16x8_t c) { return vsraq_n_u16(vshlq_n_u16(c, 3), c, 2); };
+
+    const uint16x8_t r8 = Expand(R(color));
+    const uint16x8_t g8 = Expand(vandq_u16(vshrq_n_u16(color, 5), m31));
+    const uint16x8_t b8 = Expand(B(color));
+
+    vst2q_u16((u16*)&out[x], uint16x8x2_t{{vorrq_u16(vshlq_n_u16(g8, 8), b8), vorrq_u16(alpha, r8)}});
+  }
+#else
+  ComposeLineScalar(colors_a, colors_b, effects, eva, evb, evy, greenswap, out);
+#endif
+}
+
+/**
+ * Reference implementation of ComposeLine() built on Blend(), Brighten() and Darken().
+ * Used on hosts without a vectorized path and by Benchmarks/compose.cpp to verify the vectorized paths.
+ */
+void PPU::ComposeLineScalar(
+  u16 const* colors_a,
+  u16 const* colors_b,
+  u8 const* effects,
+  int eva,
+  int evb,
+  int evy,
+  bool greenswap,
+  u32* out
+) {
+  for(int x = 0; x < 240; x += 2) {
+    u16 color_l = colors_a[x + 0];
+    u16 color_r = colors_a[x + 1];
+
+    const auto Apply = [&](u8 effect, u16 color_a, u16 color_b) -> u16 {
+      switch(effect) {
+        case EFFECT_BLEND:    return Blend(color_a, color_b, eva, evb);
+        case EFFECT_BRIGHTEN: return Brighten(color_a, evy);
+        case EFFECT_DARKEN:   return Darken(color_a, evy);
+        default:              return color_a;
+      }
+    };
+
+    color_l = Apply(effects[x + 0], color_l, colors_b[x + 0]);
+    color_r = Apply(effects[x + 1], color_r, colors_b[x + 1]);
+
+    if(greenswap) {
+      const u16 mask = 31U << 5;
+
+      u16 g_l = color_l & mask;
+      u16 g_r = color_r & mask;
+
+      color_l = (color_l & ~mask) | g_r;
+      color_r = (color_r & ~mask) | g_l;
+    }
+
+    out[x + 0] = RGB555(color_l);
+    out[x + 1] = RGB555(color_r);
+  }
+}
+
 } // namespace nba::core
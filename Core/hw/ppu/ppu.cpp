@@ -20,18 +20,18 @@ PPU::PPU(
     , irq(irq)
     , dma(dma)
     , config(config) {
-  scheduler.Register(Scheduler::EventClass::PPU_hdraw_vdraw, this, &PPU::BeginHDrawVDraw);
-  scheduler.Register(Scheduler::EventClass::PPU_hblank_vdraw, this, &PPU::BeginHBlankVDraw);
-  scheduler.Register(Scheduler::EventClass::PPU_hdraw_vblank, this, &PPU::BeginHDrawVBlank);
-  scheduler.Register(Scheduler::EventClass::PPU_hblank_vblank, this, &PPU::BeginHBlankVBlank);
-  scheduler.Register(Scheduler::EventClass::PPU_begin_sprite_fetch, this, &PPU::BeginSpriteDrawing);
-
-  scheduler.Register(Scheduler::EventClass::PPU_update_vcount_flag, this, &PPU::UpdateVerticalCounterFlag);
-  scheduler.Register(Scheduler::EventClass::PPU_video_dma, this, &PPU::RequestVideoDMA);
-  scheduler.Register(Scheduler::EventClass::PPU_latch_dispcnt, this, &PPU::LatchDISPCNT);
-  scheduler.Register(Scheduler::EventClass::PPU_hblank_irq, this, &PPU::RequestHblankIRQ);
-  scheduler.Register(Scheduler::EventClass::PPU_vblank_irq, this, &PPU::RequestVblankIRQ);
-  scheduler.Register(Scheduler::EventClass::PPU_vcount_irq, this, &PPU::RequestVcountIRQ);
+  scheduler.Register<&PPU::BeginHDrawVDraw>(Scheduler::EventClass::PPU_hdraw_vdraw, this);
+  scheduler.Register<&PPU::BeginHBlankVDraw>(Scheduler::EventClass::PPU_hblank_vdraw, this);
+  scheduler.Register<&PPU::BeginHDrawVBlank>(Scheduler::EventClass::PPU_hdraw_vblank, this);
+  scheduler.Register<&PPU::BeginHBlankVBlank>(Scheduler::EventClass::PPU_hblank_vblank, this);
+  scheduler.Register<&PPU::BeginSpriteDrawing>(Scheduler::EventClass::PPU_begin_sprite_fetch, this);
+
+  scheduler.Register<&PPU::UpdateVerticalCounterFlag>(Scheduler::EventClass::PPU_update_vcount_flag, this);
+  scheduler.Register<&PPU::RequestVideoDMA>(Scheduler::EventClass::PPU_video_dma, this);
+  scheduler.Register<&PPU::LatchDISPCNT>(Scheduler::EventClass::PPU_latch_dispcnt, this);
+  scheduler.Register<&PPU::RequestHblankIRQ>(Scheduler::EventClass::PPU_hblank_irq, this);
+  scheduler.Register<&PPU::RequestVblankIRQ>(Scheduler::EventClass::PPU_vblank_irq, this);
+  scheduler.Register<&PPU::RequestVcountIRQ>(Scheduler::EventClass::PPU_vcount_irq, this);
 
   mmio.dispcnt.ppu = this;
   mmio.dispstat.ppu = this;
@@ -42,6 +42,7 @@ void PPU::Reset() {
   std::memset(pram, 0, 0x00400);
   std::memset(oam,  0, 0x00400);
   std::memset(vram, 0, 0x18000);
+  std::memset(tile_cache.dirty, true, sizeof(tile_cache.dirty));
 
   vram_bg_latch = 0U;
 
@@ -101,6 +102,9 @@ void PPU::Reset() {
   merge = {};
 
   frame = 0;
+  have_previous_frame = false;
+  skip_frame = false;
+  frames_skipped = 0;
   dma3_video_transfer_running = false;
 }
 
@@ -139,6 +143,13 @@ void PPU::BeginHDrawVDraw() {
 }
 
 void PPU::BeginHBlankVDraw() {
+  // Draw the line as soon as it has been displayed, so that writes during H-blank do not split it.
+  if(config->video.scanline_renderer) {
+    DrawBackground();
+    DrawWindow();
+    DrawMerge();
+  }
+
   mmio.dispstat.hblank_flag = 1;
 
   RequestHblankDMA();
@@ -177,8 +188,7 @@ void PPU::BeginHDrawVBlank() {
     scheduler.Add(1007, Scheduler::EventClass::PPU_hblank_vdraw);
     vcount = 0;
 
-    config->video_dev->Draw(output[frame]);
-    frame ^= 1;
+    PresentFrame();
 
     InitBackground();
     InitMerge();
@@ -225,6 +235,45 @@ void PPU::BeginSpriteDrawing() {
   scheduler.Add(1232, Scheduler::EventClass::PPU_begin_sprite_fetch);
 }
 
+void PPU::PresentFrame() {
+  if(skip_frame) {
+    frames_skipped++;
+  } else {
+    frames_skipped = 0;
+  }
+
+  const bool skipped = skip_frame;
+
+  skip_frame = frames_skipped < config->video.frame_skip;
+
+  // The lines that were drawn anyway are overwritten in the next drawn frame.
+  if(skipped) {
+    return;
+  }
+
+  if(config->video.report_changed_lines) {
+    const u32* current  = output[frame];
+    const u32* previous = output[frame ^ 1];
+
+    VideoDevice::ChangedLines changed_lines;
+
+    if(have_previous_frame) {
+      for(int y = 0; y < 160; y++) {
+        changed_lines[y] = std::memcmp(&current[y * 240], &previous[y * 240], 240 * sizeof(u32)) != 0;
+      }
+    } else {
+      changed_lines.set();
+    }
+
+    config->video_dev->DrawChanged(output[frame], changed_lines);
+  } else {
+    config->video_dev->Draw(output[frame]);
+  }
+
+  frame ^= 1;
+  have_previous_frame = true;
+}
+
 void PPU::UpdateVerticalCounterFlag() {
   auto& dispstat = mmio.dispstat;
   auto vcount_flag_new = dispstat.vcount_setting == mmio.vcount;
@@ -64,6 +64,7 @@ void PPU::LoadState(SaveState const& state) {
   std::memcpy(pram, state.bus.memory.pram, 0x400);
   std::memcpy(oam,  state.bus.memory.oam,  0x400);
   std::memcpy(vram, state.bus.memory.vram, 0x18000);
+  InvalidateTileCache(0, 0x18000);
 
   vram_bg_latch = ss_ppu.vram_bg_latch;
   dma3_video_transfer_running = ss_ppu.dma3_video_transfer_running;
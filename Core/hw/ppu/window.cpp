@@ -5,6 +5,8 @@
  * Refer to the included LICENSE file.
  */
 
+#include <algorithm>
+
 #include <nba/hw/ppu/ppu.hpp>
 
 namespace nba::core {
@@ -37,32 +39,58 @@ void PPU::DrawWindow() {
     return;
   }
 
-  for(int i = 0; i < cycles; i++) {
-    if((window.cycle & 3U) == 0U) {
-      const uint x = window.cycle >> 2;
+  const uint cycle_end = std::min(window.cycle + (uint)cycles, 1024U);
+
+  // The window state only changes every fourth cycle (once per pixel).
+  const uint x_begin = (window.cycle + 3U) >> 2;
+  const uint x_end = (cycle_end + 3U) >> 2;
 
-      for(int i = 0; i < 2; i++) {
-        const auto& winh = mmio.winh[i];
+  // In skipped frames the merge does not compose lines that are caught up in one go, so only the flags are needed.
+  const bool skip_line = skip_frame && window.cycle == 0U && cycles >= 1006;
+
+  for(int i = 0; i < 2; i++) {
+    const auto& winh = mmio.winh[i];
+    const bool v_flag = window.v_flag[i];
 
-        if(x == winh.min) {
-          window.h_flag[i] = true;
-        }
+    bool h_flag = window.h_flag[i];
 
-        if(x == winh.max) {
-          window.h_flag[i] = false;
-        }
+    if(skip_line) {
+      const uint min = (uint)winh.min;
+      const uint max = (uint)winh.max;
 
-        if(x < 240) {
-          window.buffer[x][i] = window.h_flag[i] && window.v_flag[i];
-        }
+      const bool hit_min = min >= x_begin && min < x_end;
+      const bool hit_max = max >= x_begin && max < x_end;
+
+      // At X = min the flag is set and at X = max it is cleared (after it was set, if min = max).
+      if(hit_min && hit_max) {
+        h_flag = min > max;
+      } else if(hit_min || hit_max) {
+        h_flag = hit_min;
       }
+
+      window.h_flag[i] = h_flag;
+      continue;
     }
 
-    if(++window.cycle == 1024U) {
-      break;
+    for(uint x = x_begin; x < x_end; x++) {
+      if(x == winh.min) {
+        h_flag = true;
+      }
+
+      if(x == winh.max) {
+        h_flag = false;
+      }
+
+      if(x < 240) {
+        window.buffer[x][i] = h_flag && v_flag;
+      }
     }
+
+    window.h_flag[i] = h_flag;
   }
 
+  window.cycle = cycle_end;
+
   window.timestamp_last_sync = timestamp_now;
 }
 
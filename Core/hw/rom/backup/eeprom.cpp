@@ -22,7 +22,7 @@ EEPROM::EEPROM(fs::path const& save_path, Size size_hint, core::Scheduler& sched
     : size(size_hint)
     , save_path(save_path)
     , scheduler(scheduler) {
-  scheduler.Register(Scheduler::EventClass::EEPROM_ready, this, &EEPROM::OnReadyAfterWrite);
+  scheduler.Register<&EEPROM::OnReadyAfterWrite>(Scheduler::EventClass::EEPROM_ready, this);
   
   Reset();
 }
@@ -18,9 +18,9 @@ Timer::Timer(Scheduler& scheduler, IRQ& irq, APU& apu)
 : scheduler(scheduler)
 , irq(irq)
 , apu(apu) {
-    scheduler.Register(Scheduler::EventClass::TM_overflow, this, &Timer::OnOverflow);
-    scheduler.Register(Scheduler::EventClass::TM_write_reload, this, &Timer::OnReloadWritten);
-    scheduler.Register(Scheduler::EventClass::TM_write_control, this, &Timer::OnControlWritten);
+    scheduler.Register<&Timer::OnOverflow>(Scheduler::EventClass::TM_overflow, this);
+    scheduler.Register<&Timer::OnReloadWritten>(Scheduler::EventClass::TM_write_reload, this);
+    scheduler.Register<&Timer::OnControlWritten>(Scheduler::EventClass::TM_write_control, this);
     
     Reset();
 }
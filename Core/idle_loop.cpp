@@ -0,0 +1,482 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <nba/emulator.hpp>
+
+namespace nba::core {
+
+namespace {
+
+/* Registers r0 - r15 are tracked in bits 0 - 15 of a mask,
+ * the N, Z, C and V flags in bits 16 - 19.
+ */
+constexpr u32 kFlagN = 1 << 16;
+constexpr u32 kFlagZ = 1 << 17;
+constexpr u32 kFlagC = 1 << 18;
+constexpr u32 kFlagV = 1 << 19;
+constexpr u32 kFlagsNZ = kFlagN | kFlagZ;
+constexpr u32 kFlagsNZCV = kFlagN | kFlagZ | kFlagC | kFlagV;
+
+constexpr u32 kConditionFlags[16] {
+  kFlagZ, kFlagZ,                   // EQ, NE
+  kFlagC, kFlagC,                   // CS, CC
+  kFlagN, kFlagN,                   // MI, PL
+  kFlagV, kFlagV,                   // VS, VC
+  kFlagC | kFlagZ, kFlagC | kFlagZ, // HI, LS
+  kFlagN | kFlagV, kFlagN | kFlagV, // GE, LT
+  kFlagsNZ | kFlagV, kFlagsNZ | kFlagV, // GT, LE
+  0, 0                              // AL, NV
+};
+
+/**
+ * Tracks the data flow through a single iteration of a candidate loop.
+ * A loop qualifies as idle when each iteration only depends on
+ * loop-invariant registers and on memory that can only change
+ * on a scheduler event (IRQ handler, DMA or PPU/IRQ register update).
+ */
+struct LoopAnalysis {
+  u32 value[16];
+  u32 known = 0xFFFF; // registers whose value is known at this point
+  u32 from_entry = 0x7FFF; // known values that depend on the register state on loop entry
+  u32 defined = 0; // registers and flags written so far in this iteration
+  u32 carried = 0; // registers and flags read before being written in this iteration
+  bool cacheable = true;
+
+  void Use(u32 mask) {
+    carried |= mask & ~defined;
+  }
+
+  void Define(int reg, u32 value_, bool is_known, bool depends_on_entry) {
+    u32 bit = 1 << reg;
+
+    defined |= bit;
+    value[reg] = value_;
+    known = is_known ? (known | bit) : (known & ~bit);
+    from_entry = depends_on_entry ? (from_entry | bit) : (from_entry & ~bit);
+  }
+
+  void DefineUnknown(int reg) {
+    Define(reg, 0, false, false);
+  }
+};
+
+auto ArithmeticShift(u32 value, int type, int amount) -> u32 {
+  switch(type) {
+    case 0:  return amount >= 32 ? 0 : value << amount;
+    case 1:  return amount >= 32 ? 0 : value >> amount;
+    case 2:  return (u32)((s32)value >> std::min(amount, 31));
+    default: return std::rotr(value, amount);
+  }
+}
+
+/**
+ * Evaluates one of the data-processing operations that are common to ARM and Thumb.
+ * The opcode uses the ARM encoding. Returns false if the result can not be computed.
+ */
+auto Evaluate(int opcode, u32 op1, u32 op2, u32& result) -> bool {
+  switch(opcode) {
+    case 0x0: result = op1 & op2; return true; // AND
+    case 0x1: result = op1 ^ op2; return true; // EOR
+    case 0x2: result = op1 - op2; return true; // SUB
+    case 0x3: result = op2 - op1; return true; // RSB
+    case 0x4: result = op1 + op2; return true; // ADD
+    case 0xC: result = op1 | op2; return true; // ORR
+    case 0xD: result = op2; return true; // MOV
+    case 0xE: result = op1 & ~op2; return true; // BIC
+    case 0xF: result = ~op2; return true; // MVN
+  }
+  return false;
+}
+
+} // anonymous namespace
+
+auto Core::IsIdleLoop(u32 address_lo, u32 address_hi, bool thumb) -> bool {
+  const u32 page = address_hi >> 24;
+  const bool in_rom = page >= 0x08 && page <= 0x0D;
+  const u32 cache_key = address_hi | (thumb ? 1 : 0);
+
+  // Code in RAM may be rewritten at any time, so we only remember results for ROM.
+  if(in_rom) {
+    auto match = idle_loop_cache.find(cache_key);
+    if(match != idle_loop_cache.end()) {
+      return match->second;
+    }
+  }
+
+  LoopAnalysis loop;
+
+  for(int reg = 0; reg < 16; reg++) {
+    loop.value[reg] = cpu.state.reg[reg];
+  }
+
+  /* Reading these locations has no side effects and their values
+   * may only change on a scheduler event while the loop is running.
+   */
+  const auto IsPollableAddress = [&](u32 address) {
+    switch(address >> 24) {
+      case 0x02:
+      case 0x03:
+        return true;
+      case 0x04:
+        return (address >= 0x04000004 && address <= 0x04000007) || // DISPSTAT, VCOUNT
+               (address >= 0x04000200 && address <= 0x0400020B);   // IE, IF, WAITCNT, IME
+      case 0x08:
+      case 0x09:
+        // Exclude the GPIO port and anything outside the ROM image (open bus, EEPROM).
+        return (address < 0x080000C4 || address > 0x080000C9) &&
+               bus.GetHostAddress<u8>(address) != nullptr;
+    }
+    return false;
+  };
+
+  const auto CheckLoad = [&](int dst, int base, u32 offset) {
+    u32 base_bit = 1 << base;
+
+    loop.Use(base_bit);
+
+    if(dst == 15 || !(loop.known & base_bit) || !IsPollableAddress(loop.value[base] + offset)) {
+      return false;
+    }
+    if(loop.from_entry & base_bit) {
+      loop.cacheable = false;
+    }
+    loop.DefineUnknown(dst);
+    return true;
+  };
+
+  // A branch must either leave the loop or be the backward branch that closes it.
+  const auto CheckBranch = [&](u32 address, u32 target) {
+    if(target >= address_lo && target <= address_hi) {
+      return address == address_hi && target == address_lo;
+    }
+    return address != address_hi;
+  };
+
+  const auto AnalyzeARM = [&](u32 address, u32 instruction) -> bool {
+    const int condition = instruction >> 28;
+
+    loop.value[15] = address + 8;
+
+    // B
+    if((instruction & 0x0F000000) == 0x0A000000) {
+      loop.Use(kConditionFlags[condition]);
+      return CheckBranch(address, address + 8 + ((s32)(instruction << 8) >> 6));
+    }
+
+    if(condition != 14 || address == address_hi) {
+      return false;
+    }
+
+    const int dst  = (instruction >> 12) & 15;
+    const int base = (instruction >> 16) & 15;
+
+    // LDRH, LDRSB, LDRSH with pre-indexed immediate offset and no writeback
+    if((instruction & 0x0E000090) == 0x00000090) {
+      if((instruction & 0x01700000) == 0x01500000 && (instruction & 0x60) != 0) {
+        u32 offset = ((instruction >> 4) & 0xF0) | (instruction & 15);
+        if(~instruction & (1 << 23)) offset = -offset;
+        return CheckLoad(dst, base, offset);
+      }
+      return false;
+    }
+
+    // LDR, LDRB with pre-indexed immediate offset and no writeback
+    if((instruction & 0x0F300000) == 0x05100000) {
+      u32 offset = instruction & 0xFFF;
+      if(~instruction & (1 << 23)) offset = -offset;
+      return CheckLoad(dst, base, offset);
+    }
+
+    if((instruction & 0x0C000000) != 0) {
+      return false;
+    }
+
+    // Data-processing
+    const int  opcode = (instruction >> 21) & 15;
+    const bool set_flags = instruction & (1 << 20);
+    const bool is_compare = opcode >= 8 && opcode <= 11;
+    const bool is_logical = opcode <= 1 || opcode == 8 || opcode == 9 || opcode >= 12;
+
+    // MRS, MSR and BX share the encoding of the compare operations with S=0.
+    if((is_compare && !set_flags) || dst == 15) {
+      return false;
+    }
+
+    u32  op2 = 0;
+    bool op2_known = true;
+    bool op2_from_entry = false;
+    bool shifter_carry;
+
+    if(instruction & (1 << 25)) {
+      int shift = ((instruction >> 8) & 15) * 2;
+      op2 = std::rotr(instruction & 0xFF, shift);
+      shifter_carry = shift != 0;
+    } else {
+      // Shift by register is not worth the trouble.
+      if(instruction & (1 << 4)) {
+        return false;
+      }
+
+      int src = instruction & 15;
+      int type = (instruction >> 5) & 3;
+      int amount = (instruction >> 7) & 31;
+
+      loop.Use(1 << src);
+
+      // Only LSL #0 passes the carry flag through unmodified.
+      shifter_carry = amount != 0 || type != 0;
+
+      if(amount == 0 && type == 3) {
+        // RRX
+        loop.Use(kFlagC);
+        op2_known = false;
+      } else {
+        if(amount == 0 && type != 0) amount = 32;
+        op2 = ArithmeticShift(loop.value[src], type, amount);
+        op2_known = loop.known & (1 << src);
+        op2_from_entry = loop.from_entry & (1 << src);
+      }
+    }
+
+    u32  op1 = 0;
+    bool op1_known = true;
+    bool op1_from_entry = false;
+
+    if(opcode != 13 && opcode != 15) {
+      loop.Use(1 << base);
+      op1 = loop.value[base];
+      op1_known = loop.known & (1 << base);
+      op1_from_entry = loop.from_entry & (1 << base);
+    }
+
+    // ADC, SBC, RSC
+    if(opcode >= 5 && opcode <= 7) {
+      loop.Use(kFlagC);
+    }
+
+    if(!is_compare) {
+      u32 result = 0;
+      bool result_known = op1_known && op2_known && Evaluate(opcode, op1, op2, result);
+      loop.Define(dst, result, result_known, op1_from_entry || op2_from_entry);
+    }
+
+    if(set_flags) {
+      if(is_logical) {
+        loop.defined |= shifter_carry ? (kFlagsNZ | kFlagC) : kFlagsNZ;
+      } else {
+        loop.defined |= kFlagsNZCV;
+      }
+    }
+
+    return true;
+  };
+
+  const auto AnalyzeThumb = [&](u32 address, u16 instruction) -> bool {
+    loop.value[15] = address + 4;
+
+    // Format 16: conditional branch
+    if((instruction & 0xF000) == 0xD000 && (instruction & 0x0E00) != 0x0E00) {
+      loop.Use(kConditionFlags[(instruction >> 8) & 15]);
+      return CheckBranch(address, address + 4 + ((s32)(instruction << 24) >> 23));
+    }
+
+    // Format 18: unconditional branch
+    if((instruction & 0xF800) == 0xE000) {
+      return CheckBranch(address, address + 4 + ((s32)(instruction << 21) >> 20));
+    }
+
+    if(address == address_hi) {
+      return false;
+    }
+
+    const int dst = instruction & 7;
+    const int src = (instruction >> 3) & 7;
+
+    const auto DefineFrom = [&](int reg, u32 value, u32 sources, bool is_known) {
+      loop.Use(sources);
+      loop.Define(reg, value, is_known && (loop.known & sources) == sources, loop.from_entry & sources);
+    };
+
+    // Format 2: add/subtract
+    if((instruction & 0xF800) == 0x1800) {
+      int field = (instruction >> 6) & 7;
+      u32 sources = 1 << src;
+      u32 op2 = field;
+
+      if(~instruction & (1 << 10)) {
+        sources |= 1 << field;
+        op2 = loop.value[field];
+      }
+
+      u32 result = (instruction & (1 << 9)) ? loop.value[src] - op2 : loop.value[src] + op2;
+      DefineFrom(dst, result, sources, true);
+      loop.defined |= kFlagsNZCV;
+      return true;
+    }
+
+    // Format 1: move shifted register
+    if((instruction & 0xE000) == 0x0000) {
+      int type = (instruction >> 11) & 3;
+      int amount = (instruction >> 6) & 31;
+
+      if(amount == 0 && type != 0) amount = 32;
+
+      DefineFrom(dst, ArithmeticShift(loop.value[src], type, amount), 1 << src, true);
+      loop.defined |= amount != 0 ? (kFlagsNZ | kFlagC) : kFlagsNZ;
+      return true;
+    }
+
+    // Format 3: move/compare/add/subtract immediate
+    if((instruction & 0xE000) == 0x2000) {
+      int reg = (instruction >> 8) & 7;
+      u32 imm = instruction & 0xFF;
+
+      switch((instruction >> 11) & 3) {
+        case 0: DefineFrom(reg, imm, 0, true); break;
+        case 1: loop.Use(1 << reg); break;
+        case 2: DefineFrom(reg, loop.value[reg] + imm, 1 << reg, true); break;
+        case 3: DefineFrom(reg, loop.value[reg] - imm, 1 << reg, true); break;
+      }
+
+      loop.defined |= (instruction & 0x1800) == 0 ? kFlagsNZ : kFlagsNZCV;
+      return true;
+    }
+
+    // Format 4: ALU operations
+    if((instruction & 0xFC00) == 0x4000) {
+      static constexpr int kARMOpcode[16] {
+        0x0, 0x1, -1, -1, -1, -1, -1, -1, -1, 0x2, -1, -1, 0xC, -1, 0xE, 0xF
+      };
+
+      const int opcode = (instruction >> 6) & 15;
+      const int arm_opcode = kARMOpcode[opcode];
+      const bool has_result = opcode != 8 && opcode != 10 && opcode != 11;
+
+      u32 sources = 1 << src;
+      if(opcode != 9 && opcode != 15) {
+        sources |= 1 << dst;
+      }
+
+      // ADC, SBC
+      if(opcode == 5 || opcode == 6) {
+        loop.Use(kFlagC);
+      }
+
+      if(has_result) {
+        u32 result = 0;
+        // NEG is evaluated as zero minus the source operand.
+        u32 op1 = opcode == 9 ? 0 : loop.value[dst];
+        bool is_known = arm_opcode != -1 && Evaluate(arm_opcode, op1, loop.value[src], result);
+        DefineFrom(dst, result, sources, is_known);
+      } else {
+        loop.Use(sources);
+      }
+
+      switch(opcode) {
+        case 0x2: case 0x3: case 0x4: case 0x7: case 0xD:
+          // The carry flag is only updated for non-zero shift amounts (or undefined for MUL).
+          loop.Use(kFlagC);
+          loop.defined |= kFlagsNZ | kFlagC;
+          break;
+        case 0x5: case 0x6: case 0x9: case 0xA: case 0xB:
+          loop.defined |= kFlagsNZCV;
+          break;
+        default:
+          loop.defined |= kFlagsNZ;
+          break;
+      }
+      return true;
+    }
+
+    // Format 6: PC-relative load
+    if((instruction & 0xF800) == 0x4800) {
+      int reg = (instruction >> 8) & 7;
+      u32 literal_address = ((address + 4) & ~2) + (instruction & 0xFF) * 4;
+      u32 literal_page = literal_address >> 24;
+
+      // Literals in ROM are constant, which lets us track the loaded value.
+      if(literal_page >= 0x08 && literal_page <= 0x0D) {
+        auto literal = bus.GetHostAddress<u32>(literal_address);
+        if(literal != nullptr) {
+          loop.Define(reg, *literal, true, false);
+          return true;
+        }
+      }
+
+      loop.DefineUnknown(reg);
+      return IsPollableAddress(literal_address);
+    }
+
+    // Format 7/8: load with register offset (stores and STRH are rejected)
+    if((instruction & 0xF000) == 0x5000) {
+      int offset_reg = (instruction >> 6) & 7;
+
+      // STR, STRH, STRB
+      switch(instruction & 0x0E00) {
+        case 0x0000:
+        case 0x0200:
+        case 0x0400:
+          return false;
+      }
+
+      loop.Use(1 << offset_reg);
+      if(!(loop.known & (1 << offset_reg))) {
+        return false;
+      }
+      if(loop.from_entry & (1 << offset_reg)) {
+        loop.cacheable = false;
+      }
+      return CheckLoad(dst, src, loop.value[offset_reg]);
+    }
+
+    // Format 9: load with immediate offset
+    if((instruction & 0xE800) == 0x6800) {
+      u32 offset = (instruction >> 6) & 31;
+      if(~instruction & (1 << 12)) offset *= 4;
+      return CheckLoad(dst, src, offset);
+    }
+
+    // Format 10: load halfword
+    if((instruction & 0xF800) == 0x8800) {
+      return CheckLoad(dst, src, ((instruction >> 6) & 31) * 2);
+    }
+
+    // Format 11: SP-relative load
+    if((instruction & 0xF800) == 0x9800) {
+      return CheckLoad((instruction >> 8) & 7, 13, (instruction & 0xFF) * 4);
+    }
+
+    return false;
+  };
+
+  bool idle = true;
+
+  if(thumb) {
+    for(u32 address = address_lo; idle && address <= address_hi; address += sizeof(u16)) {
+      auto instruction = bus.GetHostAddress<u16>(address);
+      idle = instruction != nullptr && AnalyzeThumb(address, *instruction);
+    }
+  } else {
+    for(u32 address = address_lo; idle && address <= address_hi; address += sizeof(u32)) {
+      auto instruction = bus.GetHostAddress<u32>(address);
+      idle = instruction != nullptr && AnalyzeARM(address, *instruction);
+    }
+  }
+
+  // Anything read before it is written must be loop-invariant.
+  idle = idle && (loop.carried & loop.defined) == 0;
+
+  if(in_rom && (loop.cacheable || !idle)) {
+    idle_loop_cache[cache_key] = idle;
+  }
+
+  return idle;
+}
+
+} // namespace nba::core
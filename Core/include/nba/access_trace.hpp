@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <nba/integer.hpp>
+#include <vector>
+
+namespace nba {
+
+/**
+ * A data access that hit a watchpoint or was captured by access tracing.
+ */
+struct MemoryAccess {
+  enum Kind : u8 {
+    Read  = 1,
+    Write = 2
+  };
+
+  u64 timestamp; // scheduler timestamp (in cycles) at the start of the access
+  u32 pc;        // value of r15 at the time of the access (includes the pipeline offset)
+  u32 address;
+  u32 value;
+  u8  size;      // in bytes
+  Kind kind;
+  u8  access;    // Bus::Access flags, e.g. to tell CPU and DMA accesses apart
+};
+
+/**
+ * Ring buffer that carries MemoryAccess records from the emulator thread
+ * to a single consumer thread, without locking on either side.
+ * Records are dropped (and counted) while the buffer is full.
+ */
+struct AccessTrace {
+  static constexpr size_t kCapacity = 65536;
+
+  AccessTrace() : buffer{new MemoryAccess[kCapacity]} {}
+
+  AccessTrace(AccessTrace const&) = delete;
+  AccessTrace& operator=(AccessTrace const&) = delete;
+
+  // Called from the emulator thread only.
+  void Push(MemoryAccess const& record) {
+    const size_t head = this->head.load(std::memory_order_relaxed);
+
+    if(head - tail.load(std::memory_order_acquire) == kCapacity) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    buffer[head & (kCapacity - 1)] = record;
+    this->head.store(head + 1, std::memory_order_release);
+  }
+
+  // Called from the consumer thread only.
+  bool Pop(MemoryAccess& record) {
+    const size_t tail = this->tail.load(std::memory_order_relaxed);
+
+    if(tail == head.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    record = buffer[tail & (kCapacity - 1)];
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Called from the consumer thread only. Appends all pending records to the vector.
+  void Drain(std::vector<MemoryAccess>& records) {
+    MemoryAccess record;
+
+    while(Pop(record)) {
+      records.push_back(record);
+    }
+  }
+
+  // Number of records that were lost because the consumer did not keep up.
+  auto GetDroppedCount() const -> u64 {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::unique_ptr<MemoryAccess[]> buffer;
+
+  alignas(64) std::atomic<size_t> head = 0;
+  alignas(64) std::atomic<size_t> tail = 0;
+  alignas(64) std::atomic<u64> dropped = 0;
+};
+
+} // namespace nba
@@ -15,6 +15,7 @@
 #include <nba/scheduler.hpp>
 
 #include <nba/bus/bus.hpp>
+#include <nba/bus/bios_hle.hpp>
 #include <nba/arm/state.hpp>
 
 /**
@@ -33,13 +34,17 @@ struct ARM7TDMI {
   ARM7TDMI(Scheduler& scheduler, Bus& bus)
       : scheduler(scheduler)
       , bus(bus) {
-    scheduler.Register(Scheduler::EventClass::ARM_ldm_usermode_conflict, this, &ARM7TDMI::ClearLDMUsermodeConflictFlag);
+    scheduler.Register<&ARM7TDMI::ClearLDMUsermodeConflictFlag>(Scheduler::EventClass::ARM_ldm_usermode_conflict, this);
 
     Reset();
   }
 
   auto IRQLine() -> bool& { return irq_line; }
 
+  void SetBIOSHLE(BIOSHLE* bios_hle) {
+    this->bios_hle = bios_hle;
+  }
+
   void Reset() {
     state.Reset();
     SwitchMode(state.cpsr.f.mode);
@@ -270,6 +275,52 @@ private:
     return BANK_INVALID;
   }
 
+  auto HandleSWIWithHLE(int number) -> bool {
+    const bool thumb = state.cpsr.f.thumb;
+
+    const auto result = bios_hle->HandleSWI(number);
+
+    switch(result) {
+      case BIOSHLE::Result::Return: {
+        /* The BIOS returns with a branch, which refetches the following instructions.
+         * A sequential fetch would instead continue from wherever the HLE last read the ROM.
+         */
+        if(thumb) {
+          state.r15 -= 2;
+          ReloadPipeline16();
+        } else {
+          state.r15 -= 4;
+          ReloadPipeline32();
+        }
+        return true;
+      }
+      case BIOSHLE::Result::Repeat:
+      case BIOSHLE::Result::Interrupt: {
+        if(thumb) {
+          state.r15 -= 4;
+          ReloadPipeline16();
+        } else {
+          state.r15 -= 8;
+          ReloadPipeline32();
+        }
+
+        // The IRQ returns to the SWI instruction and restores CPSR.I from SPSR.
+        if(result == BIOSHLE::Result::Interrupt) {
+          latch_irq_disable = false;
+          SignalIRQ();
+        }
+        return true;
+      }
+      case BIOSHLE::Result::Jump: {
+        ReloadPipeline32();
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
   void ClearLDMUsermodeConflictFlag() {
     ldm_usermode_conflict = false;
   }
@@ -281,6 +332,7 @@ private:
 
   Scheduler& scheduler;
   Bus& bus;
+  BIOSHLE* bios_hle = nullptr;
   StatusRegister* p_spsr;
   bool ldm_usermode_conflict;
   bool cpu_mode_is_invalid;
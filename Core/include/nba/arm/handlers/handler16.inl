@@ -568,6 +568,10 @@ void Thumb_ConditionalBranch(u16 instruction) {
 }
 
 void Thumb_SWI(u16 instruction) {
+  if (bios_hle != nullptr && HandleSWIWithHLE(instruction & 0xFF)) {
+    return;
+  }
+
   // Save current program status register.
   state.spsr[BANK_SVC].v = state.cpsr.v;
 
@@ -680,6 +680,10 @@ void ARM_Undefined(u32 instruction) {
 }
 
 void ARM_SWI(u32 instruction) {
+  if (bios_hle != nullptr && HandleSWIWithHLE((instruction >> 16) & 0xFF)) {
+    return;
+  }
+
   // Save current program status register.
   state.spsr[BANK_SVC].v = state.cpsr.v;
 
@@ -5,20 +5,103 @@
  * Refer to the included LICENSE file.
  */
 
+/**
+ * Serves a read from the bus page table, when it only needs a plain memory load and a fixed cycle charge.
+ * Returns false if the access has to go through the bus.
+ */
+template<typename T>
+bool ALWAYS_INLINE ReadFast(u32 address, int access, T& value) {
+  using Type = Bus::Page::Type;
+
+  auto const& page = bus.page_table[address >> 24];
+  const u32 offset = bus.Align<T>(address) & page.mask;
+
+  if(page.type == Type::Slow || offset < page.begin || offset >= page.end || bus.hw.dma.IsRunning()) {
+    return false;
+  }
+
+  const int cycles = std::is_same_v<T, u32> ? page.wait32 : page.wait16;
+
+  switch(page.type) {
+    case Type::BIOS: {
+      if(state.r15 >= 0x4000) {
+        return false;
+      }
+      bus.Step(cycles);
+      bus.memory.latch.bios = read<u32>(page.data, offset & ~3);
+      value = (T)(bus.memory.latch.bios >> ((offset & 3) << 3));
+      break;
+    }
+    case Type::RAM: {
+      bus.Step(cycles);
+      value = read<T>(page.data, offset);
+      break;
+    }
+    case Type::ROM: {
+      // Code fetches and sequential accesses depend on the prefetch buffer and the ROM address latch.
+      if((access & (Access::Code | Access::Sequential)) || bus.prefetch.active) {
+        return false;
+      }
+      bus.Step(cycles);
+      value = read<T>(page.data, offset);
+      bus.memory.rom.SetAddressLatch((offset & ~1) + (std::is_same_v<T, u32> ? sizeof(u32) : sizeof(u16)));
+      break;
+    }
+    default: {
+      return false;
+    }
+  }
+
+  bus.parallel_internal_cpu_cycle_limit = 0;
+  bus.last_access = access;
+  return true;
+}
+
+template<typename T>
+bool ALWAYS_INLINE WriteFast(u32 address, int access, T value) {
+  auto const& page = bus.page_table[address >> 24];
+
+  if(page.type != Bus::Page::Type::RAM || bus.hw.dma.IsRunning()) {
+    return false;
+  }
+
+  bus.Step(std::is_same_v<T, u32> ? page.wait32 : page.wait16);
+  write<T>(page.writable_data, bus.Align<T>(address) & page.mask, value);
+
+  bus.parallel_internal_cpu_cycle_limit = 0;
+  bus.last_access = access;
+  return true;
+}
+
 u32 ReadByte(u32 address, int access) {
+  u8 value;
+
+  if(likely(ReadFast<u8>(address, access, value))) {
+    return value;
+  }
   return bus.ReadByte(address, access);
 }
 
 u32 ReadHalf(u32 address, int access) {
+  u16 value;
+
+  if(likely(ReadFast<u16>(address, access, value))) {
+    return value;
+  }
   return bus.ReadHalf(address, access);
 }
 
 u32 ReadWord(u32 address, int access) {
+  u32 value;
+
+  if(likely(ReadFast<u32>(address, access, value))) {
+    return value;
+  }
   return bus.ReadWord(address, access);
 }
 
 u32 ReadByteSigned(u32 address, int access) {
-  u32 value = bus.ReadByte(address, access);
+  u32 value = ReadByte(address, access);
 
   if (value & 0x80) {
     value |= 0xFFFFFF00;
@@ -28,7 +111,7 @@ u32 ReadByteSigned(u32 address, int access) {
 }
 
 u32 ReadHalfRotate(u32 address, int access) {
-  u32 value = bus.ReadHalf(address, access);
+  u32 value = ReadHalf(address, access);
 
   if (address & 1) {
     value = (value >> 8) | (value << 24);
@@ -41,12 +124,12 @@ u32 ReadHalfSigned(u32 address, int access) {
   u32 value;
 
   if (address & 1) {
-    value = bus.ReadByte(address, access);
+    value = ReadByte(address, access);
     if (value & 0x80) {
       value |= 0xFFFFFF00;
     }
   } else {
-    value = bus.ReadHalf(address, access);
+    value = ReadHalf(address, access);
     if (value & 0x8000) {
       value |= 0xFFFF0000;
     }
@@ -56,20 +139,29 @@ u32 ReadHalfSigned(u32 address, int access) {
 }
 
 u32 ReadWordRotate(u32 address, int access) {
-  auto value = bus.ReadWord(address, access);
+  auto value = ReadWord(address, access);
   auto shift = (address & 3) * 8;
 
   return (value >> shift) | (value << (32 - shift));
 }
 
 void WriteByte(u32 address, u8  value, int access) {
+  if(likely(WriteFast<u8>(address, access, value))) {
+    return;
+  }
   bus.WriteByte(address, value, access);
 }
 
 void WriteHalf(u32 address, u16 value, int access) {
+  if(likely(WriteFast<u16>(address, access, value))) {
+    return;
+  }
   bus.WriteHalf(address, value, access);
 }
 
 void WriteWord(u32 address, u32 value, int access) {
+  if(likely(WriteFast<u32>(address, access, value))) {
+    return;
+  }
   bus.WriteWord(address, value, access);
 }
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/integer.hpp>
+#include <vector>
+
+namespace nba::core {
+
+namespace arm {
+struct ARM7TDMI;
+} // namespace nba::core::arm
+
+struct Bus;
+
+/**
+ * High-level emulation of the BIOS system calls (SWIs).
+ * Supported calls are executed natively from within the SWI instruction handlers,
+ * all memory accesses still go through the Bus and computations are charged
+ * an approximate cycle count.
+ */
+struct BIOSHLE {
+  enum class Result {
+    Unhandled, // enter the SWI exception vector as usual
+    Return,    // continue after the SWI instruction
+    Repeat,    // execute the SWI instruction again (used by IntrWait)
+    Interrupt, // take the pending IRQ even if CPSR.I is set, then execute the SWI instruction again
+    Jump       // continue in ARM state at the address written to r15 (used by SoftReset)
+  };
+
+  BIOSHLE(arm::ARM7TDMI& cpu, Bus& bus) : cpu(cpu), bus(bus) {}
+
+  void Reset();
+  auto HandleSWI(int number) -> Result;
+
+  auto UseStubBIOS() -> bool& { return stub_bios; }
+
+  /**
+   * Minimal replacement BIOS image for running without a BIOS dump.
+   * It only provides the exception vectors and the IRQ dispatcher.
+   */
+  static auto GetStubImage() -> std::vector<u8>;
+
+private:
+  auto SoftReset() -> Result;
+  auto IntrWait(bool discard_old_flags, u16 wait_flags) -> Result;
+  void RegisterRamReset(u32 flags);
+  void Div(s32 numerator, s32 denominator);
+  void Sqrt(u32 value);
+  void ArcTan(s32 tan);
+  void ArcTan2(s32 x, s32 y);
+  void CpuSet(u32 src, u32 dst, u32 control);
+  void CpuFastSet(u32 src, u32 dst, u32 control);
+  void BgAffineSet(u32 src, u32 dst, int count);
+  void ObjAffineSet(u32 src, u32 dst, int count, int stride);
+  void BitUnPack(u32 src, u32 dst, u32 info);
+  void LZ77UnComp(u32 src, u32 dst, bool vram);
+  void HuffUnComp(u32 src, u32 dst);
+  void RLUnComp(u32 src, u32 dst, bool vram);
+
+  arm::ARM7TDMI& cpu;
+  Bus& bus;
+
+  // Address of the IntrWait SWI that is currently waiting for an IRQ.
+  u32 intr_wait_address = 0xFFFFFFFF;
+
+  // Whether the replacement BIOS is used, which cannot serve any SWI that is not handled here.
+  bool stub_bios = false;
+};
+
+} // namespace nba::core
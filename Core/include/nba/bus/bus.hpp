@@ -8,9 +8,12 @@
 #pragma once
 
 #include <array>
+#include <nba/access_trace.hpp>
+#include <nba/bus/host_translation.hpp>
 #include <nba/rom/rom.hpp>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
+#include <span>
 #include <vector>
 
 #include <nba/hw/apu/apu.hpp>
@@ -49,6 +52,24 @@ struct Bus {
 
   void Idle();
 
+  /**
+   * Watchpoints report data accesses which overlap [address, address + size) into the access trace.
+   * kind is a mask of MemoryAccess::Read and MemoryAccess::Write. Addresses are compared as seen
+   * on the bus, so accesses through a mirror of the watched address are not reported.
+   * With access tracing enabled, every data access is reported.
+   * Only the pages that contain a watchpoint leave the fast paths, all other memory runs at full speed.
+   */
+  void AddWatchpoint(u32 address, u32 size, int kind);
+  void RemoveWatchpoint(u32 address);
+  void ClearWatchpoints();
+  void SetAccessTracing(bool enable);
+
+  bool IsWatching() const {
+    return access_tracing || !watchpoints.empty();
+  }
+
+  AccessTrace access_trace;
+
 //private:
   Scheduler& scheduler;
 
@@ -118,8 +139,43 @@ struct Bus {
     int countdown;
     int duty;
     bool thumb;
+
+    // Timestamp up to which count, countdown and last_address are up-to-date (see SyncPrefetch)
+    u64 timestamp;
   } prefetch;
 
+  /**
+   * Host memory and access timings for each 16 MiB page of the address space.
+   * The CPU uses this to serve plain memory accesses without going through Read() and Write().
+   * Pages of type Slow (MMIO, PRAM, VRAM, OAM, SRAM and unmapped memory) always take the slow path.
+   */
+  struct Page {
+    enum class Type : u8 {
+      Slow,
+      BIOS,
+      RAM,
+      ROM
+    } type = Type::Slow;
+
+    // Host memory for reads, and for writes on RAM pages only (ROM images must never be written to).
+    u8 const* data = nullptr;
+    u8* writable_data = nullptr;
+    u32 mask = 0;
+
+    // Offsets (after masking) in [begin, end) are served from host memory.
+    u32 begin = 0;
+    u32 end = 0;
+
+    // Cycles for a 16-bit and 32-bit access (non-sequential for ROM)
+    int wait16 = 1;
+    int wait32 = 1;
+
+    // Contains a watchpoint, data accesses must go through Read() and Write() (see AddWatchpoint).
+    bool watched = false;
+  };
+
+  std::array<Page, 256> page_table;
+
   int last_access;
   int parallel_internal_cpu_cycle_limit;
 
@@ -129,21 +185,52 @@ struct Bus {
   template<typename T>
   void Write(u32 address, int access, T value);
 
+  template<typename T>
+  auto ReadMemory(u32 address, int access) -> T;
+
+  template<typename T>
+  void WriteMemory(u32 address, int access, T value);
+
+  struct Watchpoint {
+    u32 address;
+    u32 size;
+    int kind;
+  };
+
+  std::vector<Watchpoint> watchpoints;
+  bool access_tracing = false;
+
+  void OnWatchedAccess(u32 address, u64 timestamp, int size, u32 value, MemoryAccess::Kind kind, int access);
+
   template<typename T>
   auto Align(u32 address) -> u32 {
     return address & ~(sizeof(T) - 1);
   }
 
+  /**
+   * Waits for a CPU or DMA access to PRAM, VRAM or OAM to complete, which takes one cycle per 16-bit unit.
+   * The access is stalled while the PPU accesses the same memory. The PPU only needs to be synced
+   * when it may fetch from that memory, which is not the case for most of the uploads during V-blank.
+   */
+  template<bool (PPU::*IsIdle)() const noexcept, bool (PPU::*DidAccess)() noexcept>
+  void ALWAYS_INLINE StepPPUMemoryAccess(int cycles) noexcept {
+    for(int i = 0; i < cycles; i++) {
+      if((hw.ppu.*IsIdle)()) {
+        Step(1);
+      } else {
+        do {
+          Step(1);
+          hw.ppu.Sync();
+        } while((hw.ppu.*DidAccess)());
+      }
+    }
+  }
+
   template<typename T>
   auto ALWAYS_INLINE ReadPRAM(u32 address) noexcept -> T {
     constexpr int cycles = std::is_same_v<T, u32> ? 2 : 1;
 
-    for(int i = 0; i < cycles; i++) {
-      do {
-        Step(1);
-        hw.ppu.Sync();
-      } while(hw.ppu.DidAccessPRAM());
-    }
+    StepPPUMemoryAccess<&PPU::IsIdlePRAM, &PPU::DidAccessPRAM>(cycles);
 
     return hw.ppu.ReadPRAM<T>(address);
   }
@@ -151,10 +238,7 @@ struct Bus {
   template<typename T>
   void ALWAYS_INLINE WritePRAM(u32 address, T value) noexcept {
     if constexpr (!std::is_same_v<T, u32>) {
-      do {
-        Step(1);
-        hw.ppu.Sync();
-      } while(hw.ppu.DidAccessPRAM());
+      StepPPUMemoryAccess<&PPU::IsIdlePRAM, &PPU::DidAccessPRAM>(1);
 
       hw.ppu.WritePRAM<T>(address, value);
     } else {
@@ -172,21 +256,11 @@ struct Bus {
     address &= 0x1FFFF;
 
     if(address >= boundary) {
-      for(int i = 0; i < cycles; i++) {
-        do {
-          Step(1);
-          hw.ppu.Sync();
-        } while(hw.ppu.DidAccessVRAM_OBJ());
-      }
+      StepPPUMemoryAccess<&PPU::IsIdleVRAM_OBJ, &PPU::DidAccessVRAM_OBJ>(cycles);
 
       return hw.ppu.ReadVRAM_OBJ<T>(address, boundary);
     } else {
-      for(int i = 0; i < cycles; i++) {
-        do {
-          Step(1);
-          hw.ppu.Sync();
-        } while(hw.ppu.DidAccessVRAM_BG());
-      }
+      StepPPUMemoryAccess<&PPU::IsIdleVRAM_BG, &PPU::DidAccessVRAM_BG>(cycles);
 
       return hw.ppu.ReadVRAM_BG<T>(address);
     }
@@ -200,19 +274,11 @@ struct Bus {
       address &= 0x1FFFF;
 
       if(address >= boundary) {
-        // TODO: de-duplicate this code (see ReadVRAM):
-        do {
-          Step(1);
-          hw.ppu.Sync();
-        } while(hw.ppu.DidAccessVRAM_OBJ());
+        StepPPUMemoryAccess<&PPU::IsIdleVRAM_OBJ, &PPU::DidAccessVRAM_OBJ>(1);
 
         hw.ppu.WriteVRAM_OBJ<T>(address, value, boundary);
       } else {
-        // TODO: de-duplicate this code (see ReadVRAM):
-        do {
-          Step(1);
-          hw.ppu.Sync();
-        } while(hw.ppu.DidAccessVRAM_BG());
+        StepPPUMemoryAccess<&PPU::IsIdleVRAM_BG, &PPU::DidAccessVRAM_BG>(1);
 
         hw.ppu.WriteVRAM_BG<T>(address, value);
       }
@@ -224,20 +290,14 @@ struct Bus {
 
   template<typename T>
   auto ALWAYS_INLINE ReadOAM(u32 address) noexcept -> T {
-    do {
-      Step(1);
-      hw.ppu.Sync();
-    } while(hw.ppu.DidAccessOAM());
+    StepPPUMemoryAccess<&PPU::IsIdleOAM, &PPU::DidAccessOAM>(1);
 
     return hw.ppu.ReadOAM<T>(address);
   }
 
   template<typename T>
   void ALWAYS_INLINE WriteOAM(u32 address, T value) noexcept {
-    do {
-      Step(1);
-      hw.ppu.Sync();
-    } while(hw.ppu.DidAccessOAM());
+    StepPPUMemoryAccess<&PPU::IsIdleOAM, &PPU::DidAccessOAM>(1);
 
     hw.ppu.WriteOAM<T>(address, value);
   }
@@ -249,8 +309,14 @@ struct Bus {
 
   void Prefetch(u32 address, bool code, int cycles);
   void StopPrefetch();
-  void Step(int cycles);
+  void SyncPrefetch();
+  void StepPrefetch(int cycles);
   void UpdateWaitStateTable();
+  void UpdatePageTable();
+
+  void ALWAYS_INLINE Step(int cycles) {
+    scheduler.AddCycles(cycles);
+  }
 
   void LoadState(SaveState const& state);
   void CopyState(SaveState& state);
@@ -268,12 +334,49 @@ struct Bus {
 public:
   Bus(Scheduler& scheduler, Hardware&& hw);
 
-  auto GetHostAddress(u32 address, size_t size) -> u8*;
+  /**
+   * Resolves the guest address range [address, address + size) to host memory, mirrors included.
+   * Returns an empty span if the range is not backed by one contiguous block of host memory.
+   * The memory is read-only, since the ROM image may be shared with other cores.
+   */
+  auto GetHostSpan(u32 address, size_t size) -> std::span<u8 const>;
+
+  /**
+   * Like GetHostSpan(), but only resolves memory that may be written to directly (EWRAM, IWRAM and VRAM).
+   * The PPU tile cache is invalidated for VRAM ranges, so the caller must write before the PPU runs again.
+   */
+  auto GetWritableHostSpan(u32 address, size_t size) -> std::span<u8>;
+
+  auto GetHostAddress(u32 address, size_t size) -> u8 const* {
+    return GetHostSpan(address, size).data();
+  }
+
+  template<typename T>
+  auto GetHostAddress(u32 address, size_t count = 1) -> T const* {
+    return (T const*)GetHostAddress(address, sizeof(T) * count);
+  }
+
+  template<typename T>
+  auto GetWritableHostAddress(u32 address, size_t count = 1) -> T* {
+    return (T*)GetWritableHostSpan(address, sizeof(T) * count).data();
+  }
+
+  // Like GetHostSpan(), but reuses the result cached in the translation handle when possible.
+  auto Translate(HostTranslation& translation, u32 address, size_t size) -> std::span<u8 const> {
+    if(translation.generation != host_generation || translation.address != address || translation.size != size) {
+      translation = {address, size, host_generation, GetHostSpan(address, size)};
+    }
+    return translation.span;
+  }
 
   template<typename T>
-  auto GetHostAddress(u32 address, size_t count = 1) -> T* {
-    return (T*)GetHostAddress(address, sizeof(T) * count);
+  auto Translate(HostTranslation& translation, u32 address, size_t count = 1) -> T const* {
+    return (T const*)Translate(translation, address, sizeof(T) * count).data();
   }
+
+private:
+  // Incremented whenever host memory backing guest memory moves (see HostTranslation).
+  u32 host_generation = 1;
 };
 
 } // namespace nba::core
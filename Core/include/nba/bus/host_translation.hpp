@@ -0,0 +1,28 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <nba/integer.hpp>
+#include <span>
+
+namespace nba::core {
+
+/**
+ * Remembers the result of a Bus::GetHostSpan() call, so that callers which resolve
+ * the same range over and over again (such as the MP2K mixer) only pay for it once.
+ * The translation is redone when the range changes or when a new ROM is attached.
+ */
+struct HostTranslation {
+  u32 address = 0;
+  size_t size = 0;
+  u32 generation = 0;
+  std::span<u8 const> span;
+};
+
+} // namespace nba::core
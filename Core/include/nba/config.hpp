@@ -18,6 +18,33 @@ namespace nba {
 struct Config {
   bool skip_bios = false;
 
+  // Run common BIOS calls (SWIs) natively instead of interpreting the BIOS code.
+  // If no BIOS image is attached, a minimal replacement BIOS is used.
+  bool bios_hle_enable = false;
+
+  // Fast-forward to the next scheduler event whenever the CPU spins in a
+  // short loop that only polls PPU/IRQ registers or work RAM.
+  // This is not cycle-accurate, hence it is disabled by default.
+  bool skip_idle_loops = false;
+
+  // Execute LDMIA/STMIA block copy and fill loops in work RAM natively,
+  // while charging the same number of cycles as the interpreter would.
+  bool fuse_copy_loops = false;
+
+  struct Video {
+    // Draw each scanline in one go at the start of H-blank instead of cycle by cycle.
+    // Lines during which the PPU had to be synced earlier (e.g. due to a mid-line write
+    // to a PPU register, PRAM, VRAM or OAM) are still drawn cycle by cycle.
+    bool scanline_renderer = false;
+
+    // Compare each frame against the previous one and pass the changed lines to VideoDevice::DrawChanged().
+    bool report_changed_lines = false;
+
+    // Number of frames to skip after each frame that is passed to the video device (e.g. for fast-forward).
+    // Skipped frames are not composed, but PPU timing and side effects are the same as for drawn frames.
+    int frame_skip = 0;
+  } video;
+
   enum class BackupType {
     Detect,
     None,
@@ -8,6 +8,8 @@
 #pragma once
 
 #include <memory>
+#include <nba/access_trace.hpp>
+#include <nba/arm/state.hpp>
 #include <nba/rom/gpio/rtc.hpp>
 #include <nba/rom/gpio/solar_sensor.hpp>
 #include <nba/rom/rom.hpp>
@@ -15,6 +17,7 @@
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
 #include <nba/scheduler.hpp>
+#include <span>
 #include <vector>
 
 namespace nba {
@@ -36,6 +39,17 @@ enum class Key : u8 {
 struct CoreBase {
   static constexpr int kCyclesPerFrame = 280896;
 
+  /**
+   * Counters that the frontend may read (and reset) after each frame.
+   */
+  struct Statistics {
+    // Cycles fast-forwarded by idle loop detection (see Config::skip_idle_loops)
+    u64 idle_loop_cycles_skipped = 0;
+
+    // Iterations of block copy loops executed natively (see Config::fuse_copy_loops)
+    u64 copy_loop_iterations_fused = 0;
+  };
+
   virtual ~CoreBase() = default;
 
   virtual void Reset() = 0;
@@ -53,15 +67,31 @@ struct CoreBase {
   virtual auto GetPRAM() -> u8* = 0;
   virtual auto GetVRAM() -> u8* = 0;
   virtual auto GetOAM() -> u8* = 0;
+  // Read-only view of guest memory, see Bus::GetHostSpan(). Empty if the range is not plain memory.
+  virtual auto GetHostSpan(u32 address, size_t size) -> std::span<u8 const> = 0;
   // @todo: come up with a solution for reading write-only registers.
   virtual auto PeekByteIO(u32 address) -> u8  = 0;
   virtual auto PeekHalfIO(u32 address) -> u16 = 0;
   virtual auto PeekWordIO(u32 address) -> u32 = 0;
   virtual auto GetBGHOFS(int id) -> u16 = 0;
   virtual auto GetBGVOFS(int id) -> u16 = 0;
+  virtual auto GetCPURegisters() -> core::arm::RegisterFile const& = 0;
 
   virtual core::Scheduler& GetScheduler() = 0;
 
+  virtual auto GetStatistics() -> Statistics& = 0;
+
+  /**
+   * Watchpoints and access tracing for debugging, see Bus::AddWatchpoint().
+   * These must be called from the emulator thread, but the access trace
+   * may be drained from any one other thread.
+   */
+  virtual void AddWatchpoint(u32 address, u32 size, int kind) = 0;
+  virtual void RemoveWatchpoint(u32 address) = 0;
+  virtual void ClearWatchpoints() = 0;
+  virtual void SetAccessTracing(bool enable) = 0;
+  virtual auto GetAccessTrace() -> AccessTrace& = 0;
+
   void RunForOneFrame() {
     Run(kCyclesPerFrame);
   }
@@ -7,14 +7,26 @@
 
 #pragma once
 
+#include <bitset>
 #include <nba/integer.hpp>
 
 namespace nba {
 
 struct VideoDevice {
+  // One bit per scanline, set if the line differs from the line in the previously drawn frame.
+  using ChangedLines = std::bitset<160>;
+
   virtual ~VideoDevice() = default;
 
   virtual void Draw(u32* buffer) = 0;
+
+  /**
+   * Called instead of Draw() if Config::Video::report_changed_lines is set.
+   * Frontends may upload only the changed lines or skip presenting the frame if no line changed.
+   */
+  virtual void DrawChanged(u32* buffer, ChangedLines const&) {
+    Draw(buffer);
+  }
 };
 
 struct NullVideoDevice : VideoDevice {
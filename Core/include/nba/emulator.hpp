@@ -1,8 +1,12 @@
 #include <nba/core.hpp>
+#include <future>
 #include <nba/scheduler.hpp>
+#include <span>
+#include <unordered_map>
 
 #include <nba/arm/arm7tdmi.hpp>
 #include <nba/bus/bus.hpp>
+#include <nba/bus/bios_hle.hpp>
 #include <nba/hw/apu/apu.hpp>
 #include <nba/hw/ppu/ppu.hpp>
 #include <nba/hw/dma/dma.hpp>
@@ -30,20 +34,41 @@ struct Core final : CoreBase {
   auto GetPRAM() -> u8* override;
   auto GetVRAM() -> u8* override;
   auto GetOAM() -> u8* override;
+  auto GetHostSpan(u32 address, size_t size) -> std::span<u8 const> override;
   auto PeekByteIO(u32 address) -> u8  override;
   auto PeekHalfIO(u32 address) -> u16 override;
   auto PeekWordIO(u32 address) -> u32 override;
   auto GetBGHOFS(int id) -> u16 override;
   auto GetBGVOFS(int id) -> u16 override;
+  auto GetCPURegisters() -> arm::RegisterFile const& override;
 
   Scheduler& GetScheduler() override;
 
+  auto GetStatistics() -> Statistics& override;
+
+  void AddWatchpoint(u32 address, u32 size, int kind) override;
+  void RemoveWatchpoint(u32 address) override;
+  void ClearWatchpoints() override;
+  void SetAccessTracing(bool enable) override;
+  auto GetAccessTrace() -> AccessTrace& override;
+
 private:
+  void RunAndDetectLoop(u64 timestamp_limit);
   void SkipBootScreen();
-  auto SearchSoundMainRAM() -> u32;
+  void SearchSoundMainRAMAsync();
+  static auto SearchSoundMainRAM(std::span<u8 const> rom) -> u32;
+  auto IsIdleLoop(u32 address_lo, u32 address_hi, bool thumb) -> bool;
+  void FuseCopyLoop(u32 address_lo, u32 address_hi, bool thumb, u64 timestamp_limit);
 
   u32 hle_audio_hook;
+  bool hle_audio_hook_pending = false;
+  std::shared_future<u32> sound_main_ram_search;
+  HostTranslation sound_info_pointer_translation;
+  HostTranslation sound_info_translation;
+  bool has_bios = false;
   std::shared_ptr<Config> config;
+  Statistics statistics;
+  std::unordered_map<u32, bool> idle_loop_cache;
 
   Scheduler scheduler;
 
@@ -55,6 +80,7 @@ private:
   Timer timer;
   KeyPad keypad;
   Bus bus;
+  BIOSHLE bios_hle;
 };
 
 } // namespace nba::core
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <nba/bus/host_translation.hpp>
 #include <nba/integer.hpp>
 
 namespace nba::core {
@@ -116,9 +117,15 @@ private:
       u32 number_of_samples;
     } wave_info;
 
-    u8* wave_data = nullptr;
+    u8 const* wave_data = nullptr;
   } samplers[kMaxSoundChannels];
 
+  // Kept across notes, since a channel usually plays the same wave over and over again.
+  struct WaveTranslation {
+    HostTranslation info;
+    HostTranslation data;
+  } wave_translations[kMaxSoundChannels];
+
   struct Envelope {
     float volume = 0.0;
     float volume_l[2] {0.0, 0.0};
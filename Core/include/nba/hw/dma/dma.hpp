@@ -114,6 +114,17 @@ private:
   void RemoveChannelFromDMASets(Channel& channel);
   void RunChannel();
 
+  /// Host memory that a bulk transfer may access linearly, starting at some guest address.
+  struct BulkRange {
+    u8 const* data = nullptr;
+    u8* writable_data = nullptr; // null if the memory must not be written to (ROM)
+    u32 size = 0;
+    int cycles = 0;
+  };
+
+  auto GetBulkRange(u32 address, bool word) -> BulkRange;
+  bool RunChannelBulk(Channel& channel, bool did_access_rom);
+
   Bus& bus;
   IRQ& irq;
   Scheduler& scheduler;
@@ -269,4 +269,206 @@ void ALWAYS_INLINE RenderMode5BG(uint cycle) {
 
   bg.affine[0].x += mmio.bgpa[0];
   bg.affine[0].y += mmio.bgpc[0];
-}
\ No newline at end of file
+}
+/**
+ * The RenderLine*BG() methods produce the same pixels as their per-cycle counterparts,
+ * when the whole visible part of a scanline (cycles 1 - 1006) is drawn in one go.
+ * They do not update the engine state, see DrawBackgroundLine().
+ */
+
+bool ALWAYS_INLINE RenderLineMode0BG(uint id) {
+  const auto& bgcnt = mmio.bgcnt[id];
+
+  const u32 tile_base = bgcnt.tile_block << 14;
+  const u32 boundary = GetSpriteVRAMBoundary();
+
+  const uint bghofs = mmio.bghofs[id];
+
+  uint line = mmio.vcount + mmio.bgvofs[id];
+
+  if(bgcnt.mosaic_enable) {
+    line -= (uint)mmio.mosaic.bg._counter_y;
+  }
+
+  const uint grid_y = line >> 3;
+  const uint tile_y = line & 7U;
+
+  uint screen_x = 0U;
+
+  // The last tile fetched may start at X=242, outside of the visible area.
+  while(screen_x < 243U) {
+    uint map_block = bgcnt.map_block;
+
+    const uint grid_x = (bghofs + screen_x) >> 3;
+    const uint tile_x = (bghofs + screen_x) & 7U;
+
+    switch(bgcnt.size) {
+      case 1: map_block += (grid_x >> 5) & 1U; break;
+      case 2: map_block += (grid_y >> 5) & 1U; break;
+      case 3: map_block += ((grid_x >> 5) & 1U) + (((grid_y >> 5) & 1U) << 1); break;
+    }
+
+    const u32 map_address = (map_block << 11) + ((grid_y & 31U) << 6) + ((grid_x & 31U) << 1);
+
+    /**
+     * Fetches from the sprite VRAM area return the last halfword fetched by any BG (see FetchVRAM_BG),
+     * which depends on the order of the fetches. Leave these to the per-cycle path.
+     */
+    if(map_address >= boundary) {
+      return false;
+    }
+
+    const u16 tile = read<u16>(vram, map_address);
+
+    const uint number = tile & 0x3FFU;
+    const uint flip_x = (tile & (1U << 10)) ? 7U : 0U;
+    const bool flip_y = tile & (1U << 11);
+
+    const uint real_tile_y = flip_y ? (7 - tile_y) : tile_y;
+    const uint count = std::min(8U - tile_x, 240U - std::min(screen_x, 240U));
+
+    if(bgcnt.full_palette) {
+      const u32 address = tile_base + (number << 6) + (real_tile_y << 3);
+
+      if(address >= boundary) {
+        return false;
+      }
+
+      for(uint i = 0; i < count; i++) {
+        bg.buffer[screen_x + i][id] = vram[address + ((tile_x + i) ^ flip_x)];
+      }
+    } else {
+      const u32 address = tile_base + (number << 5) + (real_tile_y << 2);
+      const uint palette = (tile >> 12) << 4;
+
+      if(address >= boundary) {
+        return false;
+      }
+
+      const uint cached_tile = address >> 5;
+
+      if(tile_cache.dirty[cached_tile]) {
+        DecodeTile4BPP(cached_tile);
+      }
+
+      const u8* row = tile_cache.data[cached_tile][flip_x & 1U][real_tile_y];
+
+      for(uint i = 0; i < count; i++) {
+        uint index = row[tile_x + i];
+
+        if(index != 0U) {
+          index |= palette;
+        }
+
+        bg.buffer[screen_x + i][id] = index;
+      }
+    }
+
+    screen_x += 8U - tile_x;
+  }
+
+  return true;
+}
+
+void ALWAYS_INLINE RenderLineMode2BG(uint id) {
+  const auto& bgcnt = mmio.bgcnt[2 + id];
+
+  const int log_size = bgcnt.size;
+  const s32 size = 128 << log_size;
+  const s32 mask = size - 1;
+
+  const u32 map_base = bgcnt.map_block << 11;
+  const u32 tile_base = bgcnt.tile_block << 14;
+
+  s32 affine_x = bg.affine[id].x;
+  s32 affine_y = bg.affine[id].y;
+
+  for(uint screen_x = 0; screen_x < 240U; screen_x++) {
+    s32 x = affine_x >> 8;
+    s32 y = affine_y >> 8;
+
+    affine_x += mmio.bgpa[id];
+    affine_y += mmio.bgpc[id];
+
+    bool out_of_bounds = false;
+
+    if(bgcnt.wraparound) {
+      x &= mask;
+      y &= mask;
+    } else {
+      out_of_bounds = ((x | y) & -size) != 0;
+    }
+
+    const u8 tile = vram[(u16)(map_base + ((y >> 3) << (4 + log_size)) + (x >> 3))];
+    const u16 tile_address = tile_base + (tile << 6) + ((y & 7) << 3) + (x & 7);
+
+    bg.buffer[screen_x][2 + id] = out_of_bounds ? 0U : vram[tile_address];
+  }
+}
+
+void ALWAYS_INLINE RenderLineMode3BG() {
+  s32 affine_x = bg.affine[0].x;
+  s32 affine_y = bg.affine[0].y;
+
+  for(uint screen_x = 0; screen_x < 240U; screen_x++) {
+    const s32 x = affine_x >> 8;
+    const s32 y = affine_y >> 8;
+
+    u32 color = 0U;
+
+    if(x >= 0 && x < 240 && y >= 0 && y < 160) {
+      color = read<u16>(vram, ((u32)y * 240U + (u32)x) * 2U) | 0x8000'0000;
+    }
+
+    bg.buffer[screen_x][2] = color;
+
+    affine_x += mmio.bgpa[0];
+    affine_y += mmio.bgpc[0];
+  }
+}
+
+void ALWAYS_INLINE RenderLineMode4BG() {
+  const u32 frame_base = mmio.dispcnt.frame * 0xA000U;
+
+  s32 affine_x = bg.affine[0].x;
+  s32 affine_y = bg.affine[0].y;
+
+  for(uint screen_x = 0; screen_x < 240U; screen_x++) {
+    const s32 x = affine_x >> 8;
+    const s32 y = affine_y >> 8;
+
+    uint index = 0U;
+
+    if(x >= 0 && x < 240 && y >= 0 && y < 160) {
+      index = vram[frame_base + (u32)y * 240U + (u32)x];
+    }
+
+    bg.buffer[screen_x][2] = index;
+
+    affine_x += mmio.bgpa[0];
+    affine_y += mmio.bgpc[0];
+  }
+}
+
+void ALWAYS_INLINE RenderLineMode5BG() {
+  const u32 frame_base = mmio.dispcnt.frame * 0xA000U;
+
+  s32 affine_x = bg.affine[0].x;
+  s32 affine_y = bg.affine[0].y;
+
+  for(uint screen_x = 0; screen_x < 240U; screen_x++) {
+    const s32 x = affine_x >> 8;
+    const s32 y = affine_y >> 8;
+
+    u32 color = 0U;
+
+    if(x >= 0 && x < 160 && y >= 0 && y < 128) {
+      color = read<u16>(vram, frame_base + ((u32)y * 160U + (u32)x) * 2U) | 0x8000'0000;
+    }
+
+    bg.buffer[screen_x][2] = color;
+
+    affine_x += mmio.bgpa[0];
+    affine_y += mmio.bgpc[0];
+  }
+}
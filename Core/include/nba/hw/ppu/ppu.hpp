@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <nba/common/compiler.hpp>
 #include <nba/common/punning.hpp>
@@ -104,6 +105,10 @@ struct PPU {
     } else {
       write<T>(vram, address, value);
     }
+
+    if(address < 0x10000) {
+      tile_cache.dirty[address >> 5] = true;
+    }
   }
 
   template<typename T>
@@ -121,6 +126,18 @@ struct PPU {
     }
   }
 
+  /**
+   * Must be called after writing to VRAM without going through WriteVRAM() (address is relative to VRAM).
+   * Bus::GetWritableHostSpan() does this for its callers.
+   */
+  void ALWAYS_INLINE InvalidateTileCache(u32 address, u32 size) noexcept {
+    const u32 end = std::min(address + size, 0x10000U);
+
+    for(u32 tile = address >> 5; (tile << 5) < end; tile++) {
+      tile_cache.dirty[tile] = true;
+    }
+  }
+
   template<typename T>
   auto ALWAYS_INLINE ReadOAM(u32 address) noexcept -> T {
     return read<T>(oam, address & 0x3FF);
@@ -149,6 +166,30 @@ struct PPU {
     return scheduler.GetTimestampNow() == sprite.timestamp_oam_access + 1U;
   }
 
+  /**
+   * The IsIdle*() methods return true if the PPU will not fetch from the respective memory
+   * until a scheduler event reinitializes the engine that reads it. For example this is the case
+   * during V-blank, during forced blank (BG only) or once the sprite engine has passed its cycle limit.
+   * Accesses to that memory then can neither collide with PPU fetches nor
+   * change what the PPU would have fetched, so the PPU does not need to be synced first.
+   */
+  bool ALWAYS_INLINE IsIdlePRAM() const noexcept {
+    return merge.cycle >= 1006U;
+  }
+
+  bool ALWAYS_INLINE IsIdleVRAM_BG() const noexcept {
+    // Unlike ForcedBlank() this ignores the latched DISPCNT, which may change without a sync.
+    return bg.cycle >= 1232U || (mmio.dispcnt.hword & 0x80U);
+  }
+
+  bool ALWAYS_INLINE IsIdleVRAM_OBJ() const noexcept {
+    return sprite.cycle >= sprite.latch_cycle_limit || !mmio.dispcnt.enable[LAYER_OBJ];
+  }
+
+  bool ALWAYS_INLINE IsIdleOAM() const noexcept {
+    return IsIdleVRAM_OBJ();
+  }
+
   void Sync() {
     // @todo: only update the window when it is necessary or else
     // we will have a major performance caveat due to the window being updated 
@@ -193,6 +234,39 @@ struct PPU {
     u16 dispcnt_latch[3];
   } mmio;
 
+  enum Effect : u8 {
+    EFFECT_NONE,
+    EFFECT_BLEND,
+    EFFECT_BRIGHTEN,
+    EFFECT_DARKEN
+  };
+
+  /**
+   * Applies the color special effects to a line of 240 pixels and converts it to 32-bit ARGB
+   * (see merge.cpp). ComposeLineScalar() is the reference implementation for the vectorized paths.
+   */
+  static void ComposeLine(
+    u16 const* colors_a,
+    u16 const* colors_b,
+    u8 const* effects,
+    int eva,
+    int evb,
+    int evy,
+    bool greenswap,
+    u32* out
+  );
+
+  static void ComposeLineScalar(
+    u16 const* colors_a,
+    u16 const* colors_b,
+    u8 const* effects,
+    int eva,
+    int evb,
+    int evy,
+    bool greenswap,
+    u32* out
+  );
+
 private:
   friend struct DisplayStatus;
 
@@ -234,6 +308,7 @@ private:
   void BeginHDrawVBlank();
   void BeginHBlankVBlank();
   void BeginSpriteDrawing();
+  void PresentFrame();
 
   void UpdateVerticalCounterFlag();
   void UpdateVideoTransferDMA();
@@ -294,8 +369,20 @@ private:
     u32 buffer[240][4];
   } bg;
 
+  /**
+   * 4BPP tiles in the first 64 KiB of VRAM (where text-mode BG tiles live),
+   * decoded to one palette index per pixel, both unflipped and flipped horizontally.
+   * Used by the scanline renderer, tiles are decoded again when they are written to.
+   */
+  struct TileCache {
+    u8 data[2048][2][8][8];
+    bool dirty[2048];
+  } tile_cache;
+
   void InitBackground();
   void DrawBackground();
+  bool DrawBackgroundLine(bool render);
+  void DecodeTile4BPP(uint tile);
   template<int mode> void DrawBackgroundImpl(int cycles);
 
   struct Sprite {
@@ -398,7 +485,7 @@ private:
 
   void InitMerge();
   void DrawMerge();
-  void DrawMergeImpl(int cycles);
+  template<bool whole_line> void DrawMergeImpl(int cycles);
   
   static auto Blend(u16 color_a, u16 color_b, int eva, int evb) -> u16;
   static auto Brighten(u16 color, int evy) -> u16;
@@ -456,6 +543,9 @@ private:
 
   u32 output[2][240 * 160];
   int frame;
+  bool have_previous_frame; // output[frame ^ 1] holds the last frame passed to the video device
+  bool skip_frame;
+  int frames_skipped;
 
   bool dma3_video_transfer_running;
 
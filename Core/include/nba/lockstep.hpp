@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#pragma once
+
+#include <nba/core.hpp>
+#include <nba/integer.hpp>
+#include <optional>
+#include <string>
+
+namespace nba {
+
+/**
+ * Runs two cores side by side and reports the first point at which they diverge.
+ * This is meant for validating fast paths (e.g. copy loop fusion or idle
+ * loop skipping) against the reference interpreter.
+ * Both cores must have been set up identically (BIOS, ROM, backup, RTC) by the caller.
+ */
+struct Lockstep {
+  struct Divergence {
+    u64 timestamp; // timestamp at the start of the interval that diverged
+    u32 pc; // address of the first instruction executed in that interval
+    std::string reason;
+  };
+
+  Lockstep(CoreBase& reference, CoreBase& subject, bool compare_memory = false);
+
+  /**
+   * Runs both cores for the given number of cycles and compares their state
+   * every `interval` cycles. An interval of one compares after every instruction.
+   */
+  auto Run(int cycles, int interval = 1) -> std::optional<Divergence>;
+
+private:
+  auto Compare() -> std::optional<std::string>;
+  auto CompareMemory() -> std::optional<std::string>;
+
+  CoreBase& reference;
+  CoreBase& subject;
+  bool compare_memory;
+};
+
+} // namespace nba
@@ -9,12 +9,14 @@
 
 #include <algorithm>
 #include <memory>
+#include <utility>
 #include <nba/integer.hpp>
 #include <nba/rom/backup/eeprom.hpp>
 #include <nba/rom/gpio/gpio.hpp>
 #include <nba/common/compiler.hpp>
 #include <nba/common/punning.hpp>
 #include <nba/save_state.hpp>
+#include <span>
 #include <vector>
 
 namespace nba {
@@ -25,6 +27,29 @@ namespace nba {
  *  - optimize EEPROM check away for lower-half ROM address space
  */
 
+/**
+ * Read-only cartridge image. The data is reference-counted, so that multiple ROMs
+ * (i.e. cores running the same game) can share a single copy, for example a memory-mapped file.
+ */
+struct ROMImage {
+  ROMImage() {}
+
+  ROMImage(std::shared_ptr<u8 const[]> data, size_t size)
+      : data(std::move(data))
+      , size(size) {
+  }
+
+  explicit ROMImage(std::vector<u8>&& file_data) {
+    auto owner = std::make_shared<std::vector<u8>>(std::move(file_data));
+
+    data = std::shared_ptr<u8 const[]>{owner, owner->data()};
+    size = owner->size();
+  }
+
+  std::shared_ptr<u8 const[]> data;
+  size_t size = 0;
+};
+
 struct ROM {
   ROM() {}
 
@@ -33,14 +58,22 @@ struct ROM {
     std::unique_ptr<Backup>&& backup,
     std::unique_ptr<GPIO>&& gpio,
     u32 rom_mask = 0x01FF'FFFF
-  )   : rom(std::move(rom))
+  )   : ROM(ROMImage{std::move(rom)}, std::move(backup), std::move(gpio), rom_mask) {
+  }
+
+  ROM(
+    ROMImage image,
+    std::unique_ptr<Backup>&& backup,
+    std::unique_ptr<GPIO>&& gpio,
+    u32 rom_mask = 0x01FF'FFFF
+  )   : rom(std::move(image))
       , gpio(std::move(gpio))
       , rom_mask(rom_mask) {
     if(backup != nullptr) {
       if(typeid(*backup.get()) == typeid(EEPROM)) {
         backup_eeprom = std::move(backup);
 
-        if(this->rom.size() >= 0x0100'0001) {
+        if(rom.size >= 0x0100'0001) {
           eeprom_mask = 0x01FF'FF00;
         } else {
           eeprom_mask = 0x0100'0000;
@@ -69,7 +102,11 @@ struct ROM {
     return *this;
   }
 
-  auto GetRawROM() -> std::vector<u8>& {
+  auto GetRawROM() const -> std::span<u8 const> {
+    return {rom.data.get(), rom.size};
+  }
+
+  auto GetImage() const -> ROMImage const& {
     return rom;
   }
 
@@ -119,6 +156,29 @@ struct ROM {
     }
   }
 
+  auto GetAddressMask() const -> u32 {
+    return rom_mask;
+  }
+
+  /**
+   * Returns the range [begin, end) of ROM offsets that read plain ROM data,
+   * i.e. which are backed by the ROM image and do not map to GPIO or EEPROM.
+   */
+  auto GetPlainDataRange() const -> std::pair<u32, u32> {
+    u32 begin = gpio ? 0xCA : 0;
+    u32 end = (u32)std::min<size_t>(rom.size, 0x0200'0000) & ~3;
+
+    if(backup_eeprom) {
+      end = std::min(end, eeprom_mask);
+    }
+
+    return {begin, std::max(begin, end)};
+  }
+
+  void ALWAYS_INLINE SetAddressLatch(u32 address) {
+    rom_address_latch = address & rom_mask;
+  }
+
   auto ALWAYS_INLINE ReadROM16(u32 address, bool sequential) -> u16 {
     address &= 0x01FF'FFFE;
 
@@ -141,8 +201,8 @@ struct ROM {
       rom_address_latch = address & rom_mask;
     }
 
-    if(likely(rom_address_latch < rom.size())) {
-      data = read<u16>(rom.data(), rom_address_latch);
+    if(likely(rom_address_latch < rom.size)) {
+      data = read<u16>(rom.data.get(), rom_address_latch);
     } else {
       data = (u16)(rom_address_latch >> 1);
     }
@@ -172,8 +232,8 @@ struct ROM {
       rom_address_latch = address & rom_mask;
     }
 
-    if(likely(rom_address_latch < rom.size())) {
-      data = read<u32>(rom.data(), rom_address_latch);
+    if(likely(rom_address_latch < rom.size)) {
+      data = read<u32>(rom.data.get(), rom_address_latch);
     } else {
       const u16 lsw = (u16)(rom_address_latch >> 1);
       const u16 msw = (u16)(lsw + 1);
@@ -222,7 +282,7 @@ private:
     return backup_eeprom && (address & eeprom_mask) == eeprom_mask;
   }
 
-  std::vector<u8> rom;
+  ROMImage rom;
   std::unique_ptr<Backup> backup_sram;
   std::unique_ptr<Backup> backup_eeprom;
   std::unique_ptr<GPIO> gpio;
@@ -7,12 +7,14 @@
 
 #pragma once
 
+#include <array>
 #include <nba/log.hpp>
 #include <nba/common/compiler.hpp>
 #include <nba/integer.hpp>
 #include <nba/save_state.hpp>
-#include <functional>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace nba::core {
 
@@ -79,37 +81,29 @@ struct Scheduler {
   private:
     friend class Scheduler;
     int handle;
-    u64 key;
     u64 uid;
     u64 user_data;
     EventClass event_class;
   };
 
   Scheduler() {
-    Register(EventClass::EndOfQueue, this, &Scheduler::EndOfQueue);
-
     for(int i = 0; i < kMaxEvents; i++) {
-      heap[i] = new Event();
-      heap[i]->handle = i;
+      heap_event[i] = (u8)i;
+      events[i].handle = i;
     }
 
     for(int i = 0; i < (int)EventClass::Count; i++) {
-      callbacks[i] = [i](u64 user_data) {
-        Assert(false, "Scheduler: unhandled event class: {}", i);
-      };
+      callbacks[i] = { nullptr, &Scheduler::UnhandledEvent };
     }
 
-    Reset();
-  }
+    Register<&Scheduler::EndOfQueue>(EventClass::EndOfQueue, this);
 
- ~Scheduler() {
-    for(int i = 0; i < kMaxEvents; i++) {
-      delete heap[i];
-    }
+    Reset();
   }
 
   void Reset() {
     heap_size = 0;
+    uid_table_key.fill(0);
     timestamp_now = 0;
     next_uid = 1;
 
@@ -125,65 +119,57 @@ struct Scheduler {
   }
 
   auto GetTimestampTarget() const -> u64 {
-    return heap[0]->timestamp;
+    return timestamp_target;
   }
 
   auto GetRemainingCycleCount() const -> int {
     return int(GetTimestampTarget() - GetTimestampNow());
   }
 
-  void AddCycles(int cycles) {
+  void ALWAYS_INLINE AddCycles(int cycles) {
     auto timestamp_next = timestamp_now + cycles;
-    Step(timestamp_next);
-    timestamp_now = timestamp_next;
-  }
-
-  template<class T>
-  void Register(EventClass event_class, T* object, EventMethod<T> method, uint priority = 0) {
-    callbacks[(int)event_class] = [object, method](u64 user_data) {
-      (object->*method)();
-    };
-  }
-
-  template<class T>
-  void Register(EventClass event_class, T* object, EventMethodWithUserData<T> method, uint priority = 0) {
-    callbacks[(int)event_class] = [object, method](u64 user_data) {
-      (object->*method)(user_data);
-    };
-  }
-
-  auto Add(u64 delay, EventClass event_class, uint priority = 0, u64 user_data = 0) -> Event* {
-    int n = heap_size++;
-    int p = Parent(n);
 
-    Assert(
-      heap_size <= kMaxEvents,
-      "Scheduler: reached maximum number of events."
-    );
+#if defined(NBA_SCHEDULER_STATISTICS)
+    statistics.add_cycles_calls++;
+    statistics.heap_steps += timestamp_next >= timestamp_target;
+#endif
 
-    Assert(priority <= 3, "Scheduler: priority must be between 0 and 3.");
+    // Only consult the heap once the earliest deadline has been crossed.
+    if(unlikely(timestamp_next >= timestamp_target)) {
+      Step(timestamp_next);
+    }
 
-    auto event = heap[n];
-    event->timestamp = GetTimestampNow() + delay;
-    event->key = (event->timestamp << 2) | priority;
-    event->uid = next_uid++;
-    event->user_data = user_data;
-    event->event_class = event_class;
+    timestamp_now = timestamp_next;
+  }
 
-    while(n != 0 && heap[p]->key > heap[n]->key) {
-      Swap(n, p);
-      n = p;
-      p = Parent(n);
-    }
+#if defined(NBA_SCHEDULER_STATISTICS)
+  /**
+   * Counts how often AddCycles() had to consult the event heap, i.e. how often the
+   * fast path was missed. Only compiled in when NBA_SCHEDULER_STATISTICS is defined,
+   * so that the counting does not cost anything in regular builds.
+   */
+  struct Statistics {
+    u64 add_cycles_calls = 0;
+    u64 heap_steps = 0;
+  };
 
-    return event;
+  auto GetStatistics() -> Statistics& {
+    return statistics;
+  }
+#endif
+
+  /**
+   * The event method is a template argument, so that each event class is bound
+   * to a static trampoline which calls the method directly.
+   * This avoids the type-erasure and closure overhead of std::function.
+   */
+  template<auto method, class T>
+  void Register(EventClass event_class, T* object) {
+    callbacks[(int)event_class] = { object, &Scheduler::Trampoline<T, method> };
   }
 
-  template<class T>
-  auto Add(u64 delay, T* object, EventMethod<T> method, uint priority = 0) -> Event* {
-    return Add(delay, [object, method](int cycles_late) {
-      (object->*method)(cycles_late);
-    }, priority);
+  auto Add(u64 delay, EventClass event_class, uint priority = 0, u64 user_data = 0) -> Event* {
+    return Add(delay, event_class, priority, user_data, next_uid++);
   }
 
   void Cancel(Event* event) {
@@ -191,15 +177,17 @@ struct Scheduler {
   }
 
   auto GetEventByUID(u64 uid) -> Event* {
-    for(int i = 0; i < heap_size; i++) {
-      auto event = heap[i];
+    if(uid == 0) {
+      return nullptr;
+    }
 
-      if(event->uid == uid) {
-        return event;
-      }
+    // The UID table is not kept up to date by Add() and Remove(), it is rebuilt on a miss instead.
+    if(auto event = LookupUID(uid); event) {
+      return event;
     }
 
-    return nullptr;
+    RebuildUIDTable();
+    return LookupUID(uid);
   }
 
   void LoadState(SaveState const& state) {
@@ -219,10 +207,9 @@ struct Scheduler {
         continue;
       }
 
-      Add(timestamp - state.timestamp, event_class, priority, user_data)->uid = uid;
+      Add(timestamp - state.timestamp, event_class, priority, user_data, uid);
     }
 
-    // This must happen after deserializing all events, because calling Add() modifies `next_uid`.
     next_uid = ss_scheduler.next_uid;
   }
 
@@ -230,9 +217,9 @@ struct Scheduler {
     auto& ss_scheduler = state.scheduler;
 
     for(int i = 0; i < heap_size; i++) {
-      auto event = heap[i];
+      auto event = &events[heap_event[i]];
 
-      ss_scheduler.events[i] = { event->key, event->uid, event->user_data, (u16)event->event_class };
+      ss_scheduler.events[i] = { heap_key[i], event->uid, event->user_data, (u16)event->event_class };
     }
 
     ss_scheduler.event_count = heap_size;
@@ -242,15 +229,49 @@ struct Scheduler {
 private:
   static constexpr int kMaxEvents = 64;
 
+  // Open-addressed UID to event table, sized to always keep at least half of the slots free.
+  // It is only used when restoring event pointers from a save state, hence it is built lazily.
+  static constexpr int kUIDTableSize = kMaxEvents * 2;
+  static constexpr int kUIDTableMask = kUIDTableSize - 1;
+
   static constexpr int Parent(int n) { return (n - 1) / 2; }
   static constexpr int LeftChild(int n) { return n * 2 + 1; }
   static constexpr int RightChild(int n) { return n * 2 + 2; }
 
+  auto Add(u64 delay, EventClass event_class, uint priority, u64 user_data, u64 uid) -> Event* {
+    int n = heap_size++;
+    int p = Parent(n);
+
+    Assert(
+      heap_size <= kMaxEvents,
+      "Scheduler: reached maximum number of events."
+    );
+
+    Assert(priority <= 3, "Scheduler: priority must be between 0 and 3.");
+
+    auto event = &events[heap_event[n]];
+    event->timestamp = GetTimestampNow() + delay;
+    event->uid = uid;
+    event->user_data = user_data;
+    event->event_class = event_class;
+    heap_key[n] = (event->timestamp << 2) | priority;
+
+    while(n != 0 && heap_key[p] > heap_key[n]) {
+      Swap(n, p);
+      n = p;
+      p = Parent(n);
+    }
+
+    UpdateTimestampTarget();
+    return event;
+  }
+
   void Step(u64 timestamp_next) {
-    while(heap[0]->timestamp <= timestamp_next && heap_size > 0) {
-      auto event = heap[0];
+    while(timestamp_target <= timestamp_next && heap_size > 0) {
+      auto event = &events[heap_event[0]];
       timestamp_now = event->timestamp;
-      callbacks[(int)event->event_class](event->user_data);
+      auto& callback = callbacks[(int)event->event_class];
+      callback.function(callback.object, event->user_data);
       Remove(event->handle);
     }
   }
@@ -259,50 +280,124 @@ private:
     Swap(n, --heap_size);
 
     int p = Parent(n);
-    if(n != 0 && heap[p]->key > heap[n]->key) {
+    if(n != 0 && heap_key[p] > heap_key[n]) {
       do {
         Swap(n, p);
         n = p;
         p = Parent(n);
-      } while(n != 0 && heap[p]->key > heap[n]->key);
+      } while(n != 0 && heap_key[p] > heap_key[n]);
     } else {
       Heapify(n);
     }
+
+    UpdateTimestampTarget();
+  }
+
+  void UpdateTimestampTarget() {
+    timestamp_target = events[heap_event[0]].timestamp;
   }
 
   void Swap(int i, int j) {
-    auto tmp = heap[i];
-    heap[i] = heap[j];
-    heap[j] = tmp;
-    heap[i]->handle = i;
-    heap[j]->handle = j;
+    std::swap(heap_key[i], heap_key[j]);
+    std::swap(heap_event[i], heap_event[j]);
+    events[heap_event[i]].handle = i;
+    events[heap_event[j]].handle = j;
   }
 
   void Heapify(int n) {
-    int l = LeftChild(n);
-    int r = RightChild(n);
+    while(true) {
+      int l = LeftChild(n);
+      int r = RightChild(n);
+      int min = n;
+
+      if(l < heap_size && heap_key[l] < heap_key[min]) min = l;
+      if(r < heap_size && heap_key[r] < heap_key[min]) min = r;
+
+      if(min == n) {
+        break;
+      }
 
-    if(l < heap_size && heap[l]->key < heap[n]->key) {
-      Swap(l, n);
-      Heapify(l);
+      Swap(n, min);
+      n = min;
     }
+  }
+
+  auto LookupUID(u64 uid) -> Event* {
+    for(int i = uid & kUIDTableMask; uid_table_key[i] != 0; i = (i + 1) & kUIDTableMask) {
+      if(uid_table_key[i] == uid) {
+        auto event = &events[uid_table_event[i]];
+
+        // The entry is stale if the event has been removed (and possibly reused) since the table was built.
+        if(event->uid == uid && event->handle < heap_size) {
+          return event;
+        }
+        break;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void RebuildUIDTable() {
+    uid_table_key.fill(0);
+
+    for(int n = 0; n < heap_size; n++) {
+      const u64 uid = events[heap_event[n]].uid;
+      int i = uid & kUIDTableMask;
+
+      while(uid_table_key[i] != 0) {
+        i = (i + 1) & kUIDTableMask;
+      }
 
-    if(r < heap_size && heap[r]->key < heap[n]->key) {
-      Swap(r, n);
-      Heapify(r);
+      uid_table_key[i] = uid;
+      uid_table_event[i] = heap_event[n];
     }
   }
 
+  struct Callback {
+    void* object;
+    void (*function)(void* object, u64 user_data);
+  };
+
+  template<class T, auto method>
+  static void Trampoline(void* object, u64 user_data) {
+    if constexpr(std::is_invocable_v<decltype(method), T*, u64>) {
+      (((T*)object)->*method)(user_data);
+    } else {
+      (((T*)object)->*method)();
+    }
+  }
+
+  static void UnhandledEvent(void*, u64) {
+    Assert(false, "Scheduler: unhandled event class.");
+  }
+
   void EndOfQueue() {
     Assert(false, "Scheduler: reached end of the event queue.");
   }
 
-  Event* heap[kMaxEvents];
+  /**
+   * Events live in a fixed pool, so that Event* handed out to callers stay valid.
+   * The heap itself only holds the sort keys and pool indices in contiguous arrays,
+   * which keeps sifting within a couple of cache lines.
+   */
+  Event events[kMaxEvents];
+  u64 heap_key[kMaxEvents];
+  u8  heap_event[kMaxEvents];
   int heap_size;
+
+  std::array<u64, kUIDTableSize> uid_table_key;
+  std::array<u8, kUIDTableSize> uid_table_event;
+
   u64 timestamp_now;
+  u64 timestamp_target;
   u64 next_uid;
 
-  std::function<void(u64)> callbacks[(int)EventClass::Count];
+  Callback callbacks[(int)EventClass::Count];
+
+#if defined(NBA_SCHEDULER_STATISTICS)
+  Statistics statistics;
+#endif
 };
 
 inline u64 GetEventUID(Scheduler::Event* event) {
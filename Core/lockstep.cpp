@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2024 fleroviux
+ *
+ * Licensed under GPLv3 or any later version.
+ * Refer to the included LICENSE file.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fmt/format.h>
+#include <nba/lockstep.hpp>
+
+namespace nba {
+
+Lockstep::Lockstep(CoreBase& reference, CoreBase& subject, bool compare_memory)
+    : reference(reference)
+    , subject(subject)
+    , compare_memory(compare_memory) {
+}
+
+auto Lockstep::Run(int cycles, int interval) -> std::optional<Divergence> {
+  auto& scheduler = reference.GetScheduler();
+
+  const u64 limit = scheduler.GetTimestampNow() + cycles;
+
+  while(scheduler.GetTimestampNow() < limit) {
+    auto& regs = reference.GetCPURegisters();
+
+    const u64 timestamp = scheduler.GetTimestampNow();
+    const u32 pc = regs.r15 - (regs.cpsr.f.thumb ? 4 : 8);
+    const int step = (int)std::min<u64>(interval, limit - timestamp);
+
+    reference.Run(step);
+    subject.Run(step);
+
+    if(auto reason = Compare(); reason.has_value()) {
+      return Divergence{timestamp, pc, reason.value()};
+    }
+  }
+
+  return std::nullopt;
+}
+
+auto Lockstep::Compare() -> std::optional<std::string> {
+  const u64 timestamp_a = reference.GetScheduler().GetTimestampNow();
+  const u64 timestamp_b = subject.GetScheduler().GetTimestampNow();
+
+  if(timestamp_a != timestamp_b) {
+    return fmt::format("timestamp: {} != {}", timestamp_a, timestamp_b);
+  }
+
+  auto& regs_a = reference.GetCPURegisters();
+  auto& regs_b = subject.GetCPURegisters();
+
+  for(int i = 0; i < 16; i++) {
+    if(regs_a.reg[i] != regs_b.reg[i]) {
+      return fmt::format("r{}: 0x{:08X} != 0x{:08X}", i, regs_a.reg[i], regs_b.reg[i]);
+    }
+  }
+
+  if(regs_a.cpsr.v != regs_b.cpsr.v) {
+    return fmt::format("cpsr: 0x{:08X} != 0x{:08X}", regs_a.cpsr.v, regs_b.cpsr.v);
+  }
+
+  for(int i = 0; i < core::arm::BANK_COUNT; i++) {
+    if(regs_a.spsr[i].v != regs_b.spsr[i].v) {
+      return fmt::format("spsr[{}]: 0x{:08X} != 0x{:08X}", i, regs_a.spsr[i].v, regs_b.spsr[i].v);
+    }
+
+    for(int j = 0; j < 7; j++) {
+      if(regs_a.bank[i][j] != regs_b.bank[i][j]) {
+        return fmt::format("bank[{}][{}]: 0x{:08X} != 0x{:08X}", i, j, regs_a.bank[i][j], regs_b.bank[i][j]);
+      }
+    }
+  }
+
+  if(compare_memory) {
+    return CompareMemory();
+  }
+
+  return std::nullopt;
+}
+
+auto Lockstep::CompareMemory() -> std::optional<std::string> {
+  // The memory is compared in place, because copying a full save state per interval
+  // would cost more than running the interval itself.
+  const auto ewram_a = reference.GetHostSpan(0x02000000, 0x40000);
+  const auto ewram_b = subject.GetHostSpan(0x02000000, 0x40000);
+  const auto iwram_a = reference.GetHostSpan(0x03000000, 0x8000);
+  const auto iwram_b = subject.GetHostSpan(0x03000000, 0x8000);
+  const auto vram_a = reference.GetHostSpan(0x06000000, 0x18000);
+  const auto vram_b = subject.GetHostSpan(0x06000000, 0x18000);
+
+  const struct Region {
+    const char* name;
+    u32 base;
+    const u8* a;
+    const u8* b;
+    size_t size;
+  } regions[] {
+    {"EWRAM", 0x02000000, ewram_a.data(), ewram_b.data(), ewram_a.size()},
+    {"IWRAM", 0x03000000, iwram_a.data(), iwram_b.data(), iwram_a.size()},
+    {"PRAM",  0x05000000, reference.GetPRAM(), subject.GetPRAM(), 0x400},
+    {"VRAM",  0x06000000, vram_a.data(), vram_b.data(), vram_a.size()},
+    {"OAM",   0x07000000, reference.GetOAM(), subject.GetOAM(), 0x400}
+  };
+
+  for(auto& region : regions) {
+    if(std::memcmp(region.a, region.b, region.size) != 0) {
+      auto mismatch = std::mismatch(region.a, region.a + region.size, region.b);
+      auto offset = (u32)(mismatch.first - region.a);
+
+      return fmt::format("{} @ 0x{:08X}: 0x{:02X} != 0x{:02X}",
+        region.name, region.base + offset, *mismatch.first, *mismatch.second);
+    }
+  }
+
+  return std::nullopt;
+}
+
+} // namespace nba
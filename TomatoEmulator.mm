@@ -177,6 +177,8 @@ constexpr int operator&(GPIODeviceType lhs, GPIODeviceType rhs) {
 
 #include <nba/core.hpp>
 #include <nba/rom/backup/backup.hpp>
+#include <nba/rom/rom.hpp>
+#include <span>
 #include <string>
 
 namespace fs = std::filesystem;
@@ -207,14 +209,14 @@ struct ROMLoader {
                      ) -> Result;
     
 private:
-    static auto ReadFile(fs::path const& path, std::vector<u8>& file_data) -> Result;
+    static auto ReadFile(fs::path const& path, ROMImage& image) -> Result;
     
     static auto GetGameInfo(
-                            std::vector<u8>& file_data
+                            std::span<u8 const> file_data
                             ) -> GameInfo;
     
     static auto GetBackupType(
-                              std::vector<u8>& file_data
+                              std::span<u8 const> file_data
                               ) -> Config::BackupType;
     
     static auto CreateBackup(
@@ -572,7 +574,12 @@ const std::map<std::string, GameInfo> g_game_db {
 #include "nba/rom/header.hpp"
 #include "nba/rom/rom.hpp"
 #include "nba/log.hpp"
+#include <fcntl.h>
+#include <mutex>
 #include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <utility>
 
 namespace nba {
@@ -599,14 +606,15 @@ auto ROMLoader::Load(
                      BackupType backup_type,
                      GPIODeviceType force_gpio
                      ) -> Result {
-                         auto file_data = std::vector<u8>{};
-                         auto read_status = ReadFile(rom_path, file_data);
+                         auto image = ROMImage{};
+                         auto read_status = ReadFile(rom_path, image);
                          
                          if(read_status != Result::Success) {
                              return read_status;
                          }
                          
-                         auto size = file_data.size();
+                         auto size = image.size;
+                         auto file_data = std::span<u8 const>{image.data.get(), size};
                          
                          if(size < sizeof(Header) || size > kMaxROMSize) {
                              return Result::BadImage;
@@ -650,7 +658,7 @@ auto ROMLoader::Load(
                          }
                          
                          core->Attach(ROM{
-                             std::move(file_data),
+                             std::move(image),
                              std::move(backup),
                              std::move(gpio),
                              rom_mask
@@ -658,7 +666,37 @@ auto ROMLoader::Load(
                          return Result::Success;
                      }
 
-auto ROMLoader::ReadFile(fs::path const& path, std::vector<u8>& file_data) -> Result {
+auto ROMLoader::ReadFile(fs::path const& path, ROMImage& image) -> Result {
+    /* ROM images are memory-mapped read-only and shared between all cores that load the same file.
+     * This way the cores share physical pages and only the pages that are accessed are ever read from disk.
+     * A mapping is only reused while the file is unchanged, i.e. it has the same inode, size and modification time.
+     */
+    struct CacheEntry {
+        std::weak_ptr<u8 const[]> data;
+        dev_t device;
+        ino_t inode;
+        size_t size;
+        timespec mtime;
+        
+        static auto GetModificationTime(struct stat const& info) -> timespec {
+#ifdef __APPLE__
+            return info.st_mtimespec;
+#else
+            return info.st_mtim;
+#endif
+        }
+        
+        bool Matches(struct stat const& info) const {
+            const auto file_mtime = GetModificationTime(info);
+            
+            return device == info.st_dev && inode == info.st_ino && size == (size_t)info.st_size &&
+                   mtime.tv_sec == file_mtime.tv_sec && mtime.tv_nsec == file_mtime.tv_nsec;
+        }
+    };
+    
+    static std::mutex cache_lock;
+    static std::map<fs::path, CacheEntry> cache;
+    
     if(!fs::exists(path)) {
         return Result::CannotFindFile;
     }
@@ -667,23 +705,71 @@ auto ROMLoader::ReadFile(fs::path const& path, std::vector<u8>& file_data) -> Re
         return Result::CannotOpenFile;
     }
     
-    auto file_stream = std::ifstream{path, std::ios::binary};
+    auto error = std::error_code{};
+    auto canonical_path = fs::canonical(path, error);
+    
+    if(error) {
+        return Result::CannotOpenFile;
+    }
+    
+    // Query the file that was actually opened, so that the identity and the mapping cannot refer to different files.
+    int fd = open(canonical_path.c_str(), O_RDONLY);
     
-    if(!file_stream.good()) {
+    if(fd < 0) {
         return Result::CannotOpenFile;
     }
     
-    auto file_size = fs::file_size(path);
+    struct stat info;
+    
+    if(fstat(fd, &info) != 0) {
+        close(fd);
+        return Result::CannotOpenFile;
+    }
     
-    file_data.resize(file_size);
-    file_stream.read((char*)file_data.data(), file_size);
+    const auto file_size = (size_t)info.st_size;
+    
+    if(file_size == 0) {
+        close(fd);
+        image = {};
+        return Result::Success;
+    }
+    
+    std::lock_guard guard{cache_lock};
+    
+    // Forget the mappings that are no longer used by any core, they have been unmapped already.
+    std::erase_if(cache, [](auto const& item) { return item.second.data.expired(); });
+    
+    if(auto entry = cache.find(canonical_path); entry != cache.end()) {
+        if(auto data = entry->second.data.lock(); data && entry->second.Matches(info)) {
+            close(fd);
+            image = {std::move(data), file_size};
+            return Result::Success;
+        }
+    }
+    
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    
+    if(mapping == MAP_FAILED) {
+        return Result::CannotOpenFile;
+    }
+    
+    // Pages are faulted in on first access. Meanwhile let the OS read ahead the rest of the file in the background.
+    madvise(mapping, file_size, MADV_WILLNEED);
+    
+    auto data = std::shared_ptr<u8 const[]>{(u8 const*)mapping, [file_size](u8 const* address) {
+        munmap((void*)address, file_size);
+    }};
+    
+    cache[canonical_path] = {data, info.st_dev, info.st_ino, file_size, CacheEntry::GetModificationTime(info)};
+    image = {std::move(data), file_size};
     return Result::Success;
 }
 
 auto ROMLoader::GetGameInfo(
-                            std::vector<u8>& file_data
+                            std::span<u8 const> file_data
                             ) -> GameInfo {
-                                auto header = reinterpret_cast<Header*>(file_data.data());
+                                auto header = reinterpret_cast<Header const*>(file_data.data());
                                 auto game_code = std::string{};
                                 game_code.assign(header->game.code, 4);
                                 
@@ -696,7 +782,7 @@ auto ROMLoader::GetGameInfo(
                             }
 
 auto ROMLoader::GetBackupType(
-                              std::vector<u8>& file_data
+                              std::span<u8 const> file_data
                               ) -> BackupType {
                                   static constexpr std::pair<std::string_view, BackupType> signatures[6] {
                                       { "EEPROM_V",   BackupType::EEPROM_DETECT },
@@ -1097,7 +1183,11 @@ void EmulatorThread::ProcessMessage(const Message& message) {
     
     directory = [[[[NSFileManager defaultManager] URLsForDirectory:NSDocumentDirectory inDomains:NSUserDomainMask] firstObject] URLByAppendingPathComponent:@"Tomato"];
     
-    nba::BIOSLoader::Load(object.core, [[[directory URLByAppendingPathComponent:@"sysdata"] URLByAppendingPathComponent:@"bios.bin"].path UTF8String]);
+    auto bios_result = nba::BIOSLoader::Load(object.core, [[[directory URLByAppendingPathComponent:@"sysdata"] URLByAppendingPathComponent:@"bios.bin"].path UTF8String]);
+    if(bios_result != nba::BIOSLoader::Result::Success) {
+        // No usable BIOS image, run the BIOS calls natively instead.
+        object.config->bios_hle_enable = true;
+    }
     nba::ROMLoader::Load(object.core, [url.path UTF8String], [[[directory URLByAppendingPathComponent:@"saves"] URLByAppendingPathComponent:[name stringByAppendingString:@".sav"]].path UTF8String]);
 }
 